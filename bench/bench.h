@@ -0,0 +1,29 @@
+// SPDX-License-Identifier: EUPL-1.2
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+
+// Gemeinsame Hilfen der Benchmark-Programme in bench/. Jedes Programm ist eigenständig und wird zusammen mit src/*.cpp übersetzt.
+namespace bench {
+
+    /// <summary>
+    /// Gibt die vergangene Zeit eines monotonen Takts in Sekunden zurück.
+    /// </summary>
+    inline double seconds() {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /// <summary>
+    /// Unterdrückt für die Lebensdauer des Objekts die Ausgaben auf std::cout (Diagnosezeilen von beginMessages/endProcessMessages).
+    /// Die Ergebnisse schreiben die Programme mit printf.
+    /// </summary>
+    struct quiet_cout {
+        std::streambuf* saved;
+        quiet_cout() : saved(std::cout.rdbuf(nullptr)) {}
+        ~quiet_cout() { std::cout.rdbuf(saved); }
+    };
+}
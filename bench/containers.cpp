@@ -0,0 +1,108 @@
+// SPDX-License-Identifier: EUPL-1.2
+
+// Durchsatz von sorted_skiplist gegenüber sorted_vector und sorted_list bei 1 bis 32 Threads. Jeder Thread fügt abwechselnd
+// einen zufälligen Schlüssel ein und entfernt das erste Element ab einem zufälligen Schlüssel, die Größe bleibt so etwa konstant.
+// sorted_vector und sorted_list sind nicht threadsicher und laufen hinter einem gemeinsamen Mutex, wie im eventmanager ohne
+// SES_USE_SKIPLIST. Aufruf: containers [Elemente] [Operationen je Messung]
+
+#include "bench.h"
+#include "sorted_list.h"
+#include "sorted_skiplist.h"
+#include "sorted_vector.h"
+#include <cstdlib>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+    const uint32_t KEY_RANGE = 1u << 20;
+
+    struct locked_vector {
+        ses::sorted_vector<uint32_t> data;
+        std::mutex mtx;
+        void insert(uint32_t key) {
+            const std::lock_guard<std::mutex> lock(mtx);
+            data.push_back(key);
+        }
+        void take(uint32_t key) {
+            const std::lock_guard<std::mutex> lock(mtx);
+            auto it = data.lower_bound(key);
+            if (it != data.end()) data.remove(it);
+        }
+    };
+
+    struct locked_list {
+        ses::sorted_list<uint32_t> data;
+        std::mutex mtx;
+        void insert(uint32_t key) {
+            const std::lock_guard<std::mutex> lock(mtx);
+            data.push_back(key);
+        }
+        void take(uint32_t key) {
+            const std::lock_guard<std::mutex> lock(mtx);
+            auto it = data.lower_bound(key);
+            if (it != data.end()) data.erase_range(it, std::next(it));
+        }
+    };
+
+    struct skiplist {
+        ses::sorted_skiplist<uint32_t> data;
+        void insert(uint32_t key) {
+            data.push_back(key);
+        }
+        void take(uint32_t key) {
+            auto it = data.lower_bound(key);
+            if (it != data.end()) data.remove(it);
+        }
+    };
+
+    uint32_t next_random(uint32_t& state) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    /// <summary>
+    /// Füllt den Container, verteilt die Operationen auf die Threads und gibt den Durchsatz in Millionen Operationen je Sekunde zurück.
+    /// </summary>
+    template <class TContainer>
+    double measure(size_t elements, size_t operations, unsigned threads) {
+        TContainer container;
+        uint32_t seed = 0x9E3779B9u;
+        for (size_t i = 0; i < elements; i++) container.insert(next_random(seed) % KEY_RANGE);
+
+        std::vector<std::thread> workers;
+        const size_t perThread = operations / threads;
+        double start = bench::seconds();
+        for (unsigned t = 0; t < threads; t++) {
+            workers.emplace_back([&container, perThread, t]() {
+                uint32_t state = 0x2545F491u + t * 0x61C88647u;
+                for (size_t i = 0; i < perThread; i += 2) {
+                    container.insert(next_random(state) % KEY_RANGE);
+                    container.take(next_random(state) % KEY_RANGE);
+                }
+            });
+        }
+        for (auto& worker : workers) worker.join();
+        double elapsed = bench::seconds() - start;
+        return static_cast<double>(perThread * threads) / elapsed / 1e6;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::setvbuf(stdout, nullptr, _IOLBF, 0);
+    const size_t elements = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 2000;
+    const size_t operations = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 200000;
+
+    std::printf("%zu Elemente, %zu Operationen je Messung, Mio. Operationen/s\n", elements, operations);
+    std::printf("%8s %16s %16s %16s\n", "Threads", "sorted_skiplist", "sorted_vector", "sorted_list");
+    for (unsigned threads = 1; threads <= 32; threads *= 2) {
+        std::printf("%8u %16.2f %16.2f %16.2f\n", threads,
+            measure<skiplist>(elements, operations, threads),
+            measure<locked_vector>(elements, operations, threads),
+            measure<locked_list>(elements, operations, threads));
+    }
+    return 0;
+}
@@ -0,0 +1,70 @@
+// SPDX-License-Identifier: EUPL-1.2
+
+// Suchlatenz von sorted_eytzinger gegenüber sorted_vector für Mengen von 64 Ki bis über die Größe des L3-Caches hinaus. Gesucht wird
+// mit lower_bound nach zufälligen Schlüsseln, je Größe eine Million Suchen. sorted_eytzinger wird einmal mit Vergleichsfunktion
+// und einmal mit Sortierschlüssel gemessen. Aufruf: eytzinger [größter Exponent, Standard 27] [Suchen je Größe]
+
+#include "bench.h"
+#include "sorted_eytzinger.h"
+#include "sorted_vector.h"
+#include <cstdlib>
+#include <vector>
+
+namespace {
+    uint32_t next_random(uint32_t& state) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    /// <summary>
+    /// Sucht alle Schlüssel und gibt die mittlere Dauer einer Suche in Nanosekunden zurück. Die Summe der Treffer hält den
+    /// Übersetzer davon ab, die Suchen wegzulassen.
+    /// </summary>
+    template <class TContainer>
+    double measure(TContainer& container, const std::vector<uint32_t>& keys, uint64_t& checksum) {
+        double start = bench::seconds();
+        for (uint32_t key : keys) {
+            auto it = container.lower_bound(key);
+            if (it != container.end()) checksum += *it;
+        }
+        return (bench::seconds() - start) * 1e9 / static_cast<double>(keys.size());
+    }
+}
+
+int main(int argc, char** argv) {
+    std::setvbuf(stdout, nullptr, _IOLBF, 0);
+    const unsigned maxExponent = (argc > 1) ? static_cast<unsigned>(std::atoi(argv[1])) : 27;
+    const size_t lookups = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 1000000;
+
+    std::printf("%zu Suchen je Menge, ns je Suche\n", lookups);
+    std::printf("%12s %10s %14s %14s %18s\n", "Elemente", "MiB", "sorted_vector", "eytzinger", "eytzinger+Schl.");
+    uint64_t checksum = 0;
+    for (unsigned exponent = 16; exponent <= maxExponent; exponent++) {
+        const size_t count = size_t(1) << exponent;
+        std::vector<uint32_t> keys(lookups);
+        uint32_t state = 0x2545F491u;
+        for (auto& key : keys) key = next_random(state) % static_cast<uint32_t>(2 * count);
+
+        double vectorNs, plainNs, keyedNs;
+        {
+            ses::sorted_vector<uint32_t> vec(false);
+            for (size_t i = 0; i < count; i++) vec.push_back(static_cast<uint32_t>(2 * i + 1));
+            vec.sort();
+            vectorNs = measure(vec, keys, checksum);
+        }
+        {
+            ses::sorted_eytzinger<uint32_t> eytz(false);
+            for (size_t i = 0; i < count; i++) eytz.push_back(static_cast<uint32_t>(2 * i + 1));
+            eytz.sort();
+            plainNs = measure(eytz, keys, checksum);
+            eytz.set_key([](const uint32_t& value) { return static_cast<uint64_t>(value); }, 32);
+            keyedNs = measure(eytz, keys, checksum);
+        }
+        std::printf("%12zu %10.1f %14.1f %14.1f %18.1f\n", count, static_cast<double>(count * sizeof(uint32_t)) / (1024.0 * 1024.0),
+            vectorNs, plainNs, keyedNs);
+    }
+    std::printf("Summe %llu\n", static_cast<unsigned long long>(checksum));
+    return 0;
+}
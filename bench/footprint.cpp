@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: EUPL-1.2
+
+// Speicherbedarf der Nachrichten: Größe des Kopfs, Bytes je Nachricht mit und ohne make_message sowie der Gesamtbedarf
+// einer Million wartender Nachrichten im eventmanager.
+
+#include "bench.h"
+#include "eventmanager.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+namespace {
+    std::atomic<int64_t> g_liveBytes(0);
+    std::atomic<int64_t> g_allocations(0);
+
+    // Jeder Block trägt seine Größe vor den Nutzdaten, damit auch delete ohne Größe die lebenden Bytes kennt
+    const size_t BLOCK_HEADER = alignof(std::max_align_t);
+
+    struct payload_message : ses::message {
+        uint32_t value;
+        explicit payload_message(uint8_t prio) : message(prio, 0), value(0) {}
+        bool onMessageProcess(void*) override { return true; }
+        void onMessageExpired(void*, uint64_t) override {}
+        void onMessageDiscard(void*, uint64_t) override {}
+        void onMessagePost(void*, bool) override {}
+    };
+
+    double bytes_per(int64_t before, size_t count) {
+        return static_cast<double>(g_liveBytes.load() - before) / static_cast<double>(count);
+    }
+}
+
+void* operator new(size_t size) {
+    void* block = std::malloc(size + BLOCK_HEADER);
+    if (block == nullptr) throw std::bad_alloc();
+    *static_cast<size_t*>(block) = size;
+    g_liveBytes += static_cast<int64_t>(size);
+    g_allocations++;
+    return static_cast<uint8_t*>(block) + BLOCK_HEADER;
+}
+
+void operator delete(void* ptr) noexcept {
+    if (ptr == nullptr) return;
+    void* block = static_cast<uint8_t*>(ptr) - BLOCK_HEADER;
+    g_liveBytes -= static_cast<int64_t>(*static_cast<size_t*>(block));
+    std::free(block);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    operator delete(ptr);
+}
+
+int main() {
+    bench::quiet_cout quiet;
+    std::setvbuf(stdout, nullptr, _IOLBF, 0);
+    const size_t COUNT = 1000000;
+
+    std::printf("sizeof(message)          %zu Byte\n", sizeof(ses::message));
+    std::printf("sizeof(payload_message)  %zu Byte (4 Byte Nutzdaten)\n", sizeof(payload_message));
+
+    {
+        std::vector<std::shared_ptr<ses::message>> msgs;
+        msgs.reserve(COUNT);
+        int64_t before = g_liveBytes.load(), allocs = g_allocations.load();
+        for (size_t i = 0; i < COUNT; i++) msgs.push_back(std::shared_ptr<ses::message>(new payload_message(5)));
+        std::printf("shared_ptr(new T)        %.1f Byte je Nachricht, %.1f Allokationen\n", bytes_per(before, COUNT),
+            static_cast<double>(g_allocations.load() - allocs) / COUNT);
+    }
+    {
+        std::vector<std::shared_ptr<ses::message>> msgs;
+        msgs.reserve(COUNT);
+        int64_t before = g_liveBytes.load(), allocs = g_allocations.load();
+        for (size_t i = 0; i < COUNT; i++) msgs.push_back(ses::make_message<payload_message>(5));
+        std::printf("make_message<T>          %.1f Byte je Nachricht, %.1f Allokationen\n", bytes_per(before, COUNT),
+            static_cast<double>(g_allocations.load() - allocs) / COUNT);
+    }
+    {
+        int64_t before = g_liveBytes.load();
+        ses::eventmanager manager(1000);
+        manager.set_snapshot_interval(UINT32_MAX); // Schnappschüsse sind nicht Teil der Messung
+        // Aufsteigend über alle Prioritäten, damit das Einsortieren nur den Bereich der letzten Priorität verschiebt
+        for (size_t i = 0; i < COUNT; i++)
+            manager.postMessage(ses::make_message<payload_message>(static_cast<uint8_t>(i * 256 / COUNT)), TIMEDLOCK_INFINITY_WAIT);
+        std::printf("eventmanager, 1e6 wartend %.1f MiB, %.1f Byte je Nachricht (mit Warteschlange)\n",
+            static_cast<double>(g_liveBytes.load() - before) / (1024.0 * 1024.0), bytes_per(before, COUNT));
+        manager.clearMessages();
+    }
+    return 0;
+}
@@ -0,0 +1,75 @@
+// SPDX-License-Identifier: EUPL-1.2
+
+// Durchsatz des eventmanager ohne Journal gegenüber dem dauerhaften Modus mit verschiedenen Group-Commit-Größen. Gepostet und
+// verarbeitet wird in Blöcken, jede Nachricht trägt 16 Byte Nutzdaten. Aufruf: journal [Verzeichnis] [Nachrichten]
+
+#include "bench.h"
+#include "data_message.h"
+#include "eventmanager.h"
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+    const uint32_t TYPE_TAG = 77;
+    const size_t BLOCK = 1000;
+
+    struct record_message : ses::data_message {
+        uint64_t values[2];
+        explicit record_message(uint64_t value) : data_message(TYPE_TAG, static_cast<uint8_t>(value & 0x0F), 0) {
+            values[0] = value;
+            values[1] = ~value;
+        }
+        bool serialize(std::vector<uint8_t>& out) const override {
+            out.resize(sizeof(values));
+            std::memcpy(out.data(), values, sizeof(values));
+            return true;
+        }
+    };
+
+    uint64_t g_checksum = 0;
+
+    bool handle_record(ses::eventmanager*, ses::message& msg) {
+        g_checksum += static_cast<record_message&>(msg).values[0];
+        return true;
+    }
+
+    /// <summary>
+    /// Postet und verarbeitet count Nachrichten in Blöcken und gibt die Rate in Nachrichten je Sekunde zurück.
+    /// </summary>
+    double measure(ses::journal* pJournal, size_t count) {
+        ses::eventmanager manager(1000);
+        manager.set_snapshot_interval(UINT32_MAX);
+        manager.registerHandler(TYPE_TAG, handle_record);
+        if (pJournal != nullptr) manager.set_journal(pJournal);
+
+        double start = bench::seconds();
+        for (size_t posted = 0; posted < count; posted += BLOCK) {
+            for (size_t i = 0; i < BLOCK; i++)
+                manager.postMessage(ses::make_message<record_message>(posted + i), TIMEDLOCK_INFINITY_WAIT);
+            manager.beginMessages();
+            manager.processMessages(0, 255);
+            manager.endProcessMessages();
+        }
+        if (pJournal != nullptr) pJournal->commit();
+        return static_cast<double>(count) / (bench::seconds() - start);
+    }
+}
+
+int main(int argc, char** argv) {
+    bench::quiet_cout quiet;
+    std::setvbuf(stdout, nullptr, _IOLBF, 0);
+    const std::string directory = (argc > 1) ? argv[1] : "journal_bench";
+    const size_t count = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 200000;
+
+    std::printf("%zu Nachrichten, %zu je Block, Journal in %s\n", count, BLOCK, directory.c_str());
+    double memory = measure(nullptr, count);
+    std::printf("%-28s %12.0f Nachrichten/s\n", "im Speicher", memory);
+    for (size_t groupCommit : { size_t(1), size_t(64), size_t(1024) }) {
+        ses::journal log(directory, 4 * 1024 * 1024, groupCommit);
+        double durable = measure(&log, count);
+        std::printf("dauerhaft, Group Commit %-4zu %12.0f Nachrichten/s (%.1f %% von im Speicher)\n",
+            groupCommit, durable, 100.0 * durable / memory);
+    }
+    std::printf("Summe %llu\n", static_cast<unsigned long long>(g_checksum));
+    return 0;
+}
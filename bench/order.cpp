@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: EUPL-1.2
+
+// Anteil abgelaufener Nachrichten je Reihenfolge unter Überlast. Nachrichten treffen mit fester Rate ein, tragen eine zufällige
+// Priorität und eine zufällige Lebensdauer von 10 bis 200 ms und kosten bei der Verarbeitung je 20 µs. Die Rate liegt um den
+// Lastfaktor über dem, was verarbeitet werden kann. Posten und Verarbeiten wechseln sich in einem Thread ab, damit das Ergebnis
+// nicht von der Anzahl der Kerne abhängt. Aufruf: order [Lastfaktor] [Sekunden je Reihenfolge]
+
+#include "bench.h"
+#include "eventmanager.h"
+#include <cstdlib>
+
+namespace {
+    const double COST_SECONDS = 20e-6;
+
+    struct counters {
+        size_t processed = 0;
+        size_t expired = 0;
+    };
+
+    struct timed_message : ses::message {
+        counters* pCounters;
+        timed_message(uint8_t prio, uint32_t aliveMs, counters* pCounters_) : message(prio, aliveMs), pCounters(pCounters_) {}
+        bool onMessageProcess(void*) override {
+            double until = bench::seconds() + COST_SECONDS;
+            while (bench::seconds() < until) {}
+            pCounters->processed++;
+            return true;
+        }
+        void onMessageExpired(void*, uint64_t) override { pCounters->expired++; }
+        void onMessageDiscard(void*, uint64_t) override {}
+        void onMessagePost(void*, bool) override {}
+    };
+
+    uint32_t next_random(uint32_t& state) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    /// <summary>
+    /// Lässt die Last für die angegebene Dauer laufen. Am Ende noch wartende Nachrichten werden verworfen und nicht mitgezählt.
+    /// </summary>
+    counters measure(ses::order_policy policy, double load, double duration, size_t& posted) {
+        counters result;
+        ses::eventmanager manager(1000);
+        manager.set_snapshot_interval(UINT32_MAX);
+        manager.set_order_policy(policy);
+
+        const double interval = COST_SECONDS / load;
+        uint32_t state = 0x2545F491u;
+        ses::process_cursor cursor;
+        double start = bench::seconds(), next = start;
+        posted = 0;
+        while (bench::seconds() - start < duration) {
+            for (double now = bench::seconds(); next <= now; next += interval, posted++) {
+                uint8_t prio = static_cast<uint8_t>(next_random(state) % 16);
+                uint32_t aliveMs = 10 + next_random(state) % 191;
+                manager.postMessage(ses::make_message<timed_message>(prio, aliveMs, &result), TIMEDLOCK_INFINITY_WAIT);
+            }
+            // Jeder Zyklus beginnt vorn, damit neu eingetroffene dringende Nachrichten sofort an die Reihe kommen
+            cursor.last = nullptr;
+            manager.beginMessages();
+            manager.processMessages(0, 255, cursor, 0, 500);
+            manager.endProcessMessages();
+        }
+        manager.clearMessages();
+        return result;
+    }
+}
+
+int main(int argc, char** argv) {
+    bench::quiet_cout quiet;
+    std::setvbuf(stdout, nullptr, _IOLBF, 0);
+    const double load = (argc > 1) ? std::atof(argv[1]) : 1.2;
+    const double duration = (argc > 2) ? std::atof(argv[2]) : 3.0;
+
+    struct entry { ses::order_policy policy; const char* name; };
+    const entry policies[] = {
+        { ses::order_policy::priority, "priority" },
+        { ses::order_policy::deadline, "deadline" },
+        { ses::order_policy::priority_deadline, "priority_deadline" },
+    };
+
+    std::printf("Lastfaktor %.2f, %.1f s je Reihenfolge\n", load, duration);
+    std::printf("%-18s %10s %10s %10s %10s\n", "Reihenfolge", "gepostet", "verarbeitet", "abgelaufen", "Anteil");
+    for (const entry& e : policies) {
+        size_t posted = 0;
+        counters c = measure(e.policy, load, duration, posted);
+        std::printf("%-18s %10zu %10zu %10zu %9.1f %%\n", e.name, posted, c.processed, c.expired,
+            100.0 * static_cast<double>(c.expired) / static_cast<double>(posted));
+    }
+    return 0;
+}
@@ -0,0 +1,179 @@
+// SPDX-License-Identifier: EUPL-1.2
+
+#pragma once
+
+#include "message.h"
+#include <atomic>
+#include <mutex>
+
+#if defined(__cpp_impl_coroutine)
+#include <coroutine>
+#define SES_HAS_COROUTINES 1
+#endif
+
+namespace ses {
+
+    class eventmanager;
+
+    /// <summary>
+    /// Widerrufbare Verbindung der Tokens zu ihrem eventmanager. clearMessages und der Destruktor des eventmanagers trennen sie,
+    /// danach gemeldete Abschlüsse werden verworfen.
+    /// </summary>
+    class SES_API async_link {
+    public:
+        explicit async_link(eventmanager* manager) : m_pManager(manager) {}
+
+        /// <summary>
+        /// Reicht den Abschluss an den eventmanager weiter, solange die Verbindung besteht.
+        /// </summary>
+        /// <param name="msg">Die asynchron verarbeitete Nachricht.</param>
+        /// <param name="success">true, wenn die Nachricht erfolgreich verarbeitet wurde, andernfalls false.</param>
+        void complete(const std::shared_ptr<message>& msg, bool success);
+        /// <summary>
+        /// Trennt die Verbindung. Ein gerade laufender Abschluss wird abgewartet.
+        /// </summary>
+        void revoke() {
+            const std::lock_guard<std::mutex> lock(m_mtx);
+            m_pManager = nullptr;
+        }
+    private:
+        std::mutex m_mtx;
+        eventmanager* m_pManager;
+    };
+
+    /// <summary>
+    /// Abschluss-Token einer asynchron verarbeiteten Nachricht. Das Ergebnis wird über complete gemeldet und beim
+    /// nächsten Verarbeitungsdurchlauf wie der Rückgabewert von onMessageProcess ausgewertet (set_runned bzw. discardMessage).
+    /// Wird die letzte Kopie ohne complete zerstört, gilt die Verarbeitung als fehlgeschlagen.
+    /// </summary>
+    class SES_API async_token {
+    public:
+        /// <summary>
+        /// Konstruiert ein leeres Token, dessen Abschluss ignoriert wird.
+        /// </summary>
+        async_token() {}
+        /// <summary>
+        /// Konstruiert ein Token für die angegebene Nachricht.
+        /// </summary>
+        /// <param name="link">Die Verbindung zum eventmanager, der die Nachricht verarbeitet.</param>
+        /// <param name="msg">Die Nachricht, deren Verarbeitung aussteht.</param>
+        async_token(std::shared_ptr<async_link> link, std::shared_ptr<message> msg)
+            : m_ptrState(std::make_shared<state>(std::move(link), std::move(msg))) {}
+
+        /// <summary>
+        /// Meldet das Ergebnis der Verarbeitung. Nur der erste Aufruf wird berücksichtigt, der Aufruf ist aus jedem Thread erlaubt.
+        /// </summary>
+        /// <param name="success">true, wenn die Nachricht erfolgreich verarbeitet wurde, andernfalls false.</param>
+        void complete(bool success);
+
+        /// <summary>
+        /// Prüft, ob das Ergebnis bereits gemeldet wurde.
+        /// </summary>
+        /// <returns>Gibt true zurück, wenn complete bereits aufgerufen wurde, andernfalls false.</returns>
+        bool is_completed() const { return m_ptrState && m_ptrState->done.load(); }
+    private:
+        // Von allen Kopien geteilt, die letzte meldet einen ausstehenden Abschluss als Fehlschlag
+        struct state {
+            state(std::shared_ptr<async_link> l, std::shared_ptr<message> m) : link(std::move(l)), msg(std::move(m)), done(false) {}
+            ~state() {
+                if (!done.exchange(true)) link->complete(msg, false);
+            }
+            std::shared_ptr<async_link> link;
+            std::shared_ptr<message> msg;
+            std::atomic<bool> done;
+        };
+        std::shared_ptr<state> m_ptrState;
+    };
+
+    /// <summary>
+    /// Nachricht, deren Verarbeitung asynchron abgeschlossen wird. Der Worker wird nach dem Start sofort freigegeben,
+    /// die Nachricht bleibt bis zum Abschluss über das Token in der Warteschlange und wird nicht erneut verarbeitet.
+    /// </summary>
+    class SES_API async_message : public message {
+    public:
+        /// <summary>
+        /// Konstruiert eine asynchrone Nachricht.
+        /// </summary>
+        /// <param name="prio">Die Priorität der Nachricht.</param>
+        /// <param name="ms">Die Lebensdauer der Nachricht in Millisekunden (Standardwert: 1000).</param>
+        /// <param name="bIsSystem">Gibt an, ob es sich um eine Systemnachricht handelt (Standardwert: false).</param>
+        async_message(uint8_t prio, uint32_t ms = 1000, bool bIsSystem = false)
+            : message(prio, ms, bIsSystem) { set_flag(flag_async, true); }
+
+        virtual ~async_message() {}
+
+        /// <summary>
+        /// Startet die Verarbeitung der Nachricht. Das Ergebnis wird später über token.complete gemeldet.
+        /// </summary>
+        /// <param name="sender">Ein Zeiger auf das Objekt, das die Nachricht verarbeitet.</param>
+        /// <param name="token">Das Token, über das der Abschluss gemeldet wird.</param>
+        virtual void onMessageProcessAsync(void* sender, async_token token) = 0;
+
+        /// <summary>
+        /// Wird vom eventmanager bei asynchronen Nachrichten nicht aufgerufen.
+        /// </summary>
+        virtual bool onMessageProcess(void* /*sender*/) { return false; }
+    };
+
+#ifdef SES_HAS_COROUTINES
+    /// <summary>
+    /// Rückgabetyp eines Coroutine-Handlers. Der Wert von co_return wird als Verarbeitungsergebnis gemeldet.
+    /// </summary>
+    class message_task {
+    public:
+        struct promise_type {
+            async_token token;
+            bool result = false;
+
+            message_task get_return_object() { return message_task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept {
+                token.complete(result);
+                return {};
+            }
+            void return_value(bool success) { result = success; }
+            void unhandled_exception() { result = false; }
+        };
+
+        message_task(message_task&& other) noexcept : m_handle(other.m_handle) { other.m_handle = nullptr; }
+        message_task(const message_task&) = delete;
+        ~message_task() {
+            if (m_handle) m_handle.destroy();
+        }
+
+        /// <summary>
+        /// Startet die Coroutine. Der Rahmen gibt sich nach co_return selbst frei.
+        /// </summary>
+        /// <param name="token">Das Token, über das der Abschluss gemeldet wird.</param>
+        void start(async_token token) {
+            std::coroutine_handle<promise_type> handle = m_handle;
+            m_handle = nullptr;
+            handle.promise().token = std::move(token);
+            handle.resume();
+        }
+    private:
+        explicit message_task(std::coroutine_handle<promise_type> handle) : m_handle(handle) {}
+
+        std::coroutine_handle<promise_type> m_handle;
+    };
+
+    /// <summary>
+    /// Asynchrone Nachricht, deren Verarbeitung als Coroutine geschrieben wird.
+    /// </summary>
+    class SES_API coro_message : public async_message {
+    public:
+        coro_message(uint8_t prio, uint32_t ms = 1000, bool bIsSystem = false)
+            : async_message(prio, ms, bIsSystem) {}
+
+        /// <summary>
+        /// Coroutine zur Verarbeitung der Nachricht, das Ergebnis wird mit co_return geliefert.
+        /// </summary>
+        /// <param name="sender">Ein Zeiger auf das Objekt, das die Nachricht verarbeitet.</param>
+        virtual message_task onMessageCoroutine(void* sender) = 0;
+
+        virtual void onMessageProcessAsync(void* sender, async_token token) {
+            onMessageCoroutine(sender).start(std::move(token));
+        }
+    };
+#endif
+}
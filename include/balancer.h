@@ -0,0 +1,115 @@
+// SPDX-License-Identifier: EUPL-1.2
+
+#pragma once
+
+#include "eventmanager.h"
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+
+namespace ses {
+
+    /// <summary>
+    /// Zusammenhängender Prioritätsbereich [from, to] eines Workers.
+    /// </summary>
+    struct range_assignment {
+        uint8_t from;
+        uint8_t to;
+    };
+
+    /// <summary>
+    /// Eintrag im Verlauf der Neuverteilungen.
+    /// </summary>
+    struct rebalance_record {
+        uint64_t time;                          // tool::now() der Neuverteilung
+        std::vector<range_assignment> ranges;   // Neue Bereiche je Worker
+        double imbalance_before;                // Größte / mittlere Last je Worker mit der alten Verteilung
+        double imbalance_after;                 // Dasselbe Maß mit der neuen Verteilung
+    };
+
+    /// <summary>
+    /// Verteilt die Prioritäten eines eventmanager in zusammenhängenden Bereichen auf eine feste Anzahl Worker und passt die Bereiche
+    /// periodisch der gemessenen Last an. Die Last einer Priorität ist ihre geglättete Ankunftsrate mal ihrer mittleren Handler-Dauer.
+    /// Jede Priorität gehört immer genau einem Worker, Bereiche wechseln nur zwischen zwei Verarbeitungszyklen, sodass die Reihenfolge
+    /// innerhalb einer Priorität erhalten bleibt.
+    /// </summary>
+    class SES_API balancer {
+    public:
+        /// <summary>
+        /// Konstruiert einen balancer und schaltet die Statistik des eventmanager ein. Anfangs sind die Prioritäten gleichmäßig verteilt.
+        /// </summary>
+        /// <param name="manager">Der eventmanager, der den balancer überleben muss.</param>
+        /// <param name="workers">Die Anzahl Worker (1 bis 256).</param>
+        /// <param name="intervalMs">Der Mindestabstand zweier Neuverteilungen in Millisekunden (Standard: 1000).</param>
+        balancer(eventmanager& manager, size_t workers, uint64_t intervalMs = 1000);
+
+        balancer(const balancer&) = delete;
+        balancer& operator=(const balancer&) = delete;
+
+        /// <summary>
+        /// Führt einen Verarbeitungszyklus (begin, process, end) im aktuellen Bereich des Workers aus und verteilt bei abgelaufenem Intervall neu.
+        /// </summary>
+        /// <param name="worker">Der Index des Workers.</param>
+        bool processMessages(size_t worker);
+
+        /// <summary>
+        /// Misst die Last seit der letzten Messung und verteilt neu, wenn das Intervall abgelaufen ist.
+        /// </summary>
+        /// <returns>Gibt true zurück, wenn sich die Bereiche geändert haben.</returns>
+        bool update();
+        /// <summary>
+        /// Misst und verteilt sofort neu. Die neue Verteilung wird nur übernommen, wenn sie die größte Last je Worker um mehr als die Hysterese senkt.
+        /// </summary>
+        /// <returns>Gibt true zurück, wenn sich die Bereiche geändert haben.</returns>
+        bool rebalance();
+
+        /// <summary>
+        /// Gibt den aktuellen Bereich eines Workers zurück.
+        /// </summary>
+        range_assignment get_range(size_t worker) const;
+        /// <summary>
+        /// Gibt die aktuellen Bereiche aller Worker zurück.
+        /// </summary>
+        std::vector<range_assignment> get_assignment() const;
+        /// <summary>
+        /// Gibt die letzten Neuverteilungen zurück, die älteste zuerst (höchstens set_history_limit Einträge).
+        /// </summary>
+        std::vector<rebalance_record> get_history() const;
+        /// <summary>
+        /// Gibt die geglättete Last einer Priorität in Nanosekunden Handler-Zeit pro Sekunde zurück.
+        /// </summary>
+        double get_load(uint8_t prio) const;
+
+        size_t get_workers() const { return m_vecRanges.size(); }
+        /// <summary>
+        /// Setzt den Glättungsfaktor der Lastmessung (0 = nur alte Werte, 1 = nur die letzte Messung, Standard: 0.5).
+        /// </summary>
+        void set_smoothing(double alpha);
+        /// <summary>
+        /// Setzt die relative Verbesserung der größten Last je Worker, ab der neu verteilt wird (Standard: 0.1).
+        /// </summary>
+        void set_hysteresis(double ratio);
+        void set_history_limit(size_t limit);
+    private:
+        void measure(uint64_t now);
+        double imbalance(const std::vector<range_assignment>& ranges) const;
+        std::vector<range_assignment> partition() const;
+    private:
+        eventmanager& m_manager;
+        uint64_t m_ulInterval;
+        std::atomic<uint64_t> m_ulLastTime; // Zeitpunkt der letzten Messung, update prüft ohne Sperre
+        double m_dSmoothing;
+        double m_dHysteresis;
+        size_t m_ulHistoryLimit;
+        priority_stats m_stats;             // Zählerstand der letzten Messung
+        double m_aLoad[256];                // Geglättete Last je Priorität
+        double m_aCost[256];                // Geglättete mittlere Handler-Dauer je Priorität
+        std::vector<range_assignment> m_vecRanges;
+        std::deque<rebalance_record> m_deqHistory;
+        mutable std::mutex m_mtxMeasure;    // Eine Messung zur Zeit
+        mutable std::shared_timed_mutex m_mtxRanges; // Worker teilen, Neuverteilung exklusiv
+    };
+}
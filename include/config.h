@@ -8,4 +8,14 @@
 #define SES_API __declspec(dllimport)
 #endif
 
-#define TIMEDLOCK_INFINITY_WAIT 0
\ No newline at end of file
+#define TIMEDLOCK_INFINITY_WAIT 0
+
+// Nebenläufige Skip-Liste statt sorted_vector als Warteschlange des eventmanager verwenden
+// #define SES_USE_SKIPLIST
+
+// Lebenslauf der Nachrichten im tracer aufzeichnen (siehe tracer.h), ohne das Makro entfallen alle Aufzeichnungspunkte
+// #define SES_TRACE
+
+// Sendezeitpunkt der Nachrichten als 32-Bit-Versatz in ms statt als 64-Bit-Zeitstempel speichern (message schrumpft auf 32-Bit-Systemen
+// um 4 Byte, auf 64-Bit-Systemen bleibt es bei 32 Byte), darstellbar sind etwa ±24 Tage um den ersten Zeitstempel des Prozesses
+// #define SES_COMPACT_TIMESTAMP
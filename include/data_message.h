@@ -0,0 +1,33 @@
+// SPDX-License-Identifier: EUPL-1.2
+
+#pragma once
+
+#include "message.h"
+
+namespace ses {
+
+	/// <summary>
+	/// Reine Datennachricht ohne eigene Verarbeitungslogik. Sie wird über die Dispatch-Tabelle des eventmanager
+	/// anhand ihrer Typkennung verarbeitet (siehe eventmanager::registerHandler).
+	/// </summary>
+	class SES_API data_message : public message {
+	public:
+		/// <summary>
+		/// Konstruiert eine Datennachricht mit Typkennung, Priorität und Lebensdauer.
+		/// </summary>
+		/// <param name="type_tag">Die Typkennung, über die der Handler gewählt wird.</param>
+		/// <param name="prio">Die Priorität der Nachricht.</param>
+		/// <param name="ms">Die Lebensdauer der Nachricht in Millisekunden (Standardwert: 1000).</param>
+		data_message(uint32_t type_tag, uint8_t prio, uint32_t ms = 1000)
+			: message(prio, ms) { set_typetag(type_tag); }
+
+		/// <summary>
+		/// Ohne registrierten Handler kann die Nachricht nicht verarbeitet werden und wird verworfen.
+		/// </summary>
+		virtual bool onMessageProcess(void* /*sender*/) { return false; }
+
+		virtual void onMessageExpired(void* /*sender*/, uint64_t /*time*/) {}
+		virtual void onMessageDiscard(void* /*sender*/, uint64_t /*time*/) {}
+		virtual void onMessagePost(void* /*sender*/, bool /*bWasAdd*/) {}
+	};
+}
@@ -0,0 +1,135 @@
+// SPDX-License-Identifier: EUPL-1.2
+
+#pragma once
+
+#include "eventmanager.h"
+#include "forward_message.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ses {
+
+    /// <summary>
+    /// Bedingung einer Routing-Regel des eventbus.
+    /// </summary>
+    enum class route_match : uint8_t {
+        /// <summary>Jede Nachricht.</summary>
+        any = 0,
+        /// <summary>Interne Nachrichten (id::msg == 1).</summary>
+        internal,
+        /// <summary>Externe Nachrichten (id::msg == 0).</summary>
+        external,
+        /// <summary>Nachrichten aus einer Gruppe (id::gr == 1).</summary>
+        group,
+        /// <summary>Einzelnachrichten (id::gr == 0).</summary>
+        single,
+        /// <summary>Interne Nachrichten, deren System-ID (Typkennung) in [low, high] liegt.</summary>
+        system_id,
+        /// <summary>Nachrichten, deren Typkennung in [low, high] liegt.</summary>
+        typetag,
+        /// <summary>Jede Nachricht, verteilt über einen Hash der ID auf genau eines der Ziele statt an alle.</summary>
+        hash
+    };
+
+    /// <summary>
+    /// Routing-Regel: passende Nachrichten gehen an alle Ziele, bei route_match::hash an genau eines.
+    /// </summary>
+    struct route_rule {
+        route_match match;
+        uint32_t low;                   // Untere Grenze für system_id und typetag
+        uint32_t high;                  // Obere Grenze für system_id und typetag
+        std::vector<size_t> targets;    // Indizes aus eventbus::attach
+    };
+
+    /// <summary>
+    /// Verteilt gepostete Nachrichten nach Regeln auf mehrere eventmanager, z. B. einen je Subsystem. Die erste passende Regel gewinnt.
+    /// Nachrichten werden je Ziel gesammelt und blockweise mit eventmanager::postMessages übergeben, sodass jeder Lock nur einmal je
+    /// Block genommen wird. Ein Block wird übergeben, sobald er voll ist oder seine älteste Nachricht maxLinger ms gewartet hat. Geht eine Nachricht an mehrere Ziele, erhält das erste die Nachricht selbst und jedes weitere eine
+    /// forward_message, die Nutzdaten werden nicht kopiert. Asynchrone Nachrichten gehen nur an das erste Ziel.
+    /// Manager und Regeln werden vor dem ersten postMessage eingerichtet, postMessage und flush sind danach threadsicher.
+    /// </summary>
+    class SES_API eventbus {
+    public:
+        using message_ptr = eventmanager::message_ptr;
+
+        /// <summary>
+        /// Konstruiert einen eventbus.
+        /// </summary>
+        /// <param name="batchSize">Die Anzahl gesammelter Nachrichten je Ziel, ab der automatisch übergeben wird (1 = sofort).</param>
+        /// <param name="maxWaitTime">Die maximale Wartezeit auf den Lock eines Ziels je Block.</param>
+        /// <param name="maxLinger">Die Zeit in ms, nach der ein nicht voller Block übergeben wird (0 = nur volle Blöcke und flush).</param>
+        eventbus(size_t batchSize = 64, uint64_t maxWaitTime = 10, uint64_t maxLinger = 10);
+        /// <summary>
+        /// Übergibt noch gesammelte Nachrichten.
+        /// </summary>
+        ~eventbus();
+
+        eventbus(const eventbus&) = delete;
+        eventbus& operator=(const eventbus&) = delete;
+
+        /// <summary>
+        /// Hängt einen eventmanager an, der den eventbus überleben muss.
+        /// </summary>
+        /// <returns>Der Index des Managers für route_rule::targets.</returns>
+        size_t attach(eventmanager& manager);
+        /// <summary>
+        /// Hängt eine Regel hinter die bestehenden an.
+        /// </summary>
+        void add_route(const route_rule& rule);
+        void clear_routes();
+
+        /// <summary>
+        /// Leitet eine Nachricht nach der ersten passenden Regel weiter. Ohne passende Regel erhält sie onMessagePost(nullptr, false),
+        /// da kein eventmanager beteiligt ist.
+        /// </summary>
+        /// <param name="msg">Die Nachricht.</param>
+        /// <returns>Die Anzahl der Ziele, für die die Nachricht gesammelt wurde (0 = keine passende Regel).</returns>
+        size_t postMessage(const message_ptr& msg);
+        /// <summary>
+        /// Übergibt die gesammelten Nachrichten aller Ziele.
+        /// </summary>
+        void flush();
+        /// <summary>
+        /// Übergibt die gesammelten Nachrichten eines Ziels.
+        /// </summary>
+        void flush(size_t target);
+        /// <summary>
+        /// Übergibt die Blöcke, deren älteste Nachricht maxLinger ms gewartet hat. postMessage prüft nur das Ziel, an das es sammelt,
+        /// in Phasen ohne Posts ruft der Aufrufer flush_due periodisch auf, z. B. vor jedem Verarbeitungszyklus.
+        /// </summary>
+        /// <returns>Die Anzahl übergebener Blöcke.</returns>
+        size_t flush_due();
+
+        size_t get_managers() const { return m_vecTargets.size(); }
+        eventmanager& get_manager(size_t target) { return *m_vecTargets[target]->manager; }
+        /// <summary>
+        /// Gibt die Anzahl der Nachrichten ohne passende Regel zurück.
+        /// </summary>
+        uint64_t get_unrouted() const { return m_ulUnrouted.load(); }
+        /// <summary>
+        /// Gibt die Anzahl der von den Zielen abgelehnten Übergaben zurück (Timeout, Kapazität, Early Drop).
+        /// </summary>
+        uint64_t get_rejected() const { return m_ulRejected.load(); }
+    private:
+        struct target {
+            eventmanager* manager;
+            std::mutex mtxQueue;                // Schützt vecQueue
+            std::mutex mtxFlush;                // Hält die Reihenfolge der Blöcke bei gleichzeitigem flush ein
+            std::vector<message_ptr> vecQueue;
+            uint64_t ulFirstQueued;             // Zeitpunkt der ältesten gesammelten Nachricht
+        };
+
+        const route_rule* findRoute(const message& msg) const;
+        void enqueue(size_t index, message_ptr msg);
+    private:
+        size_t m_ulBatchSize;
+        uint64_t m_ulMaxWait;
+        uint64_t m_ulMaxLinger;
+        std::vector<std::unique_ptr<target>> m_vecTargets;
+        std::vector<route_rule> m_vecRules;
+        std::atomic<uint64_t> m_ulUnrouted;
+        std::atomic<uint64_t> m_ulRejected;
+    };
+}
@@ -1,42 +1,404 @@
 /**
 * SES Smart Event System
-* (c) 2025 Amber-Sophia Schrck
+* (c) 2025 Amber-Sophia Schröck
 * This file is copyright under the latest version of the EUPL.
 * Please see LICENSE file for your rights under this license.
 **/
 #pragma once
 #include "message.h"
+#include "async_message.h"
+#include "journal.h"
+#include "queue_snapshot.h"
+#include "reclaimer.h"
+#include "notifier.h"
+#include "recorder.h"
+#include <atomic>
+#include <condition_variable>
 #include <mutex>
 #include <chrono>
+#include <functional>
+#include <unordered_map>
+#ifdef SES_USE_SKIPLIST
+#include "sorted_skiplist.h"
+#else
 #include "sorted_vector.h"
+#endif
 #include "timed_lock.h"
 
 namespace ses {
 
+    /// <summary>
+    /// Verhalten, wenn ein Prioritätsband seine Kapazität erreicht.
+    /// </summary>
+    enum class shed_policy : uint8_t {
+        /// <summary>Die neue Nachricht wird abgelehnt.</summary>
+        reject_newest = 0,
+        /// <summary>Die älteste Nachricht der niedrigsten Priorität im Band wird entfernt, sofern sie nicht wichtiger als die neue ist.</summary>
+        evict_oldest,
+        /// <summary>Ab halber Füllung werden neue Nachrichten mit steigender Wahrscheinlichkeit abgelehnt.</summary>
+        early_drop
+    };
+
+    /// <summary>
+    /// Reihenfolge, in der wartende Nachrichten gehalten und verarbeitet werden.
+    /// </summary>
+    enum class order_policy : uint8_t {
+        /// <summary>Nur nach Priorität (Standard).</summary>
+        priority = 0,
+        /// <summary>Nach Ablaufzeitpunkt (earliest deadline first), Nachrichten ohne Lebensdauer zuletzt.</summary>
+        deadline,
+        /// <summary>Nach Priorität, innerhalb einer Priorität nach Ablaufzeitpunkt.</summary>
+        priority_deadline
+    };
+
+    /// <summary>
+    /// Fortsetzungspunkt eines budgetierten processMessages. Ein neuer oder zurückgesetzter Cursor beginnt am Anfang der Warteschlange.
+    /// </summary>
+    struct process_cursor {
+        std::shared_ptr<message> last; // Zuletzt bearbeitete Nachricht, nullptr = von vorn
+        size_t processed;              // Im letzten Aufruf bearbeitete Nachrichten
+        bool complete;                 // Der letzte Aufruf hat das Ende der Warteschlange erreicht
+
+        process_cursor() : processed(0), complete(false) { }
+        void reset() {
+            last = nullptr;
+            processed = 0;
+            complete = false;
+        }
+    };
+
+    /// <summary>
+    /// Laufende Zähler je Priorität seit dem Einschalten der Statistik, siehe eventmanager::set_statistics.
+    /// </summary>
+    struct priority_stats {
+        uint64_t arrivals[256];  // Eingereihte Nachrichten
+        uint64_t processed[256]; // Handler-Aufrufe
+        uint64_t cost_ns[256];   // Summe der Handler-Dauern in Nanosekunden
+    };
+
     class SES_API eventmanager {
     public:
         using message_ptr = std::shared_ptr<message>;
         using id_type = typename message::id_type;
+        /// <summary>
+        /// Container der wartenden Nachrichten, mit SES_USE_SKIPLIST eine nebenläufige Skip-Liste.
+        /// </summary>
+#ifdef SES_USE_SKIPLIST
+        using message_container = sorted_skiplist<message_ptr>;
+#else
+        using message_container = sorted_vector<message_ptr>;
+#endif
+        /// <summary>
+        /// Handler, der alle bereiten Nachrichten einer Typkennung als zusammenhängenden Block erhält.
+        /// Gibt true zurück, wenn der Block verarbeitet wurde, andernfalls werden alle Nachrichten verworfen.
+        /// </summary>
+        using batch_func = std::function<bool(eventmanager* sender, message_ptr* msgs, size_t count)>;
+        /// <summary>
+        /// Eintrag der Dispatch-Tabelle, der eine Nachricht anhand ihrer Typkennung verarbeitet.
+        /// Gibt true zurück, wenn die Nachricht erfolgreich verarbeitet wurde, andernfalls false.
+        /// </summary>
+        using handler_func = bool(*)(eventmanager* sender, message& msg);
+
+        /// <summary>
+        /// Abonnement eines Prioritätsbereichs, dessen Handle lesbar bzw. gesetzt wird, sobald dort eine Nachricht eintrifft.
+        /// </summary>
+        class SES_API subscription {
+        public:
+            notify_handle get_handle() const { return m_event.get_handle(); }
+            uint8_t get_from() const { return m_ucFrom; }
+            uint8_t get_to() const { return m_ucTo; }
+        private:
+            friend class eventmanager;
+            subscription(uint8_t from, uint8_t to) : m_ucFrom(from), m_ucTo(to), m_bSignaled(false) { }
+
+            uint8_t m_ucFrom;
+            uint8_t m_ucTo;
+            notifier m_event;
+            std::atomic<bool> m_bSignaled; // Bis acknowledge lösen weitere Nachrichten kein Signal aus
+        };
+        using subscription_ptr = std::shared_ptr<subscription>;
 
         eventmanager(uint64_t timedWaitMax);
+        /// <summary>
+        /// Trennt ausstehende async_token vom eventmanager, ihre Abschlüsse werden danach verworfen.
+        /// </summary>
+        ~eventmanager();
 
-        void postMessage(message_ptr msg, uint64_t maxWaitTime);
+        post_result postMessage(message_ptr msg, uint64_t maxWaitTime);
+        /// <summary>
+        /// Reiht mehrere Nachrichten unter einer einzigen Lock-Übernahme ein. Jede Nachricht erhält ihr Ergebnis wie bei postMessage.
+        /// </summary>
+        /// <param name="msgs">Die Nachrichten.</param>
+        /// <param name="count">Die Anzahl der Nachrichten.</param>
+        /// <param name="maxWaitTime">Die maximale Wartezeit auf den Lock für den gesamten Block.</param>
+        /// <returns>Die Anzahl eingefügter, zusammengefasster oder aus einem Handler zurückgestellter Nachrichten.</returns>
+        size_t postMessages(const message_ptr* msgs, size_t count, uint64_t maxWaitTime);
         void clearMessages();
 
+        /// <summary>
+        /// Begrenzt die Anzahl wartender Nachrichten im Prioritätsband [from, to]. Überlappende Bänder ersetzen ältere Einstellungen.
+        /// </summary>
+        /// <param name="from">Die erste Priorität des Bandes.</param>
+        /// <param name="to">Die letzte Priorität des Bandes.</param>
+        /// <param name="capacity">Die maximale Anzahl wartender Nachrichten im Band.</param>
+        /// <param name="policy">Das Verhalten bei voller Kapazität.</param>
+        void set_capacity(uint8_t from, uint8_t to, size_t capacity, shed_policy policy = shed_policy::reject_newest);
+        /// <summary>
+        /// Entfernt alle Kapazitätsgrenzen.
+        /// </summary>
+        void clear_capacity();
+
+        /// <summary>
+        /// Setzt die Reihenfolge der wartenden Nachrichten. Vorhandene Nachrichten werden einmalig umsortiert,
+        /// neue Nachrichten werden per binärer Suche an der passenden Stelle eingefügt.
+        /// </summary>
+        /// <param name="policy">Die neue Reihenfolge.</param>
+        void set_order_policy(order_policy policy);
+        /// <summary>
+        /// Gibt die aktuelle Reihenfolge der wartenden Nachrichten zurück.
+        /// </summary>
+        order_policy get_order_policy() const { return m_eOrder; }
+
+        /// <summary>
+        /// Aktiviert den dauerhaften Modus: gepostete Nachrichten werden im Journal aufgezeichnet, abgeschlossene erhalten einen Grabstein.
+        /// Das Journal gehört dem Aufrufer und muss den eventmanager überleben.
+        /// </summary>
+        /// <param name="pJournal">Das Journal oder nullptr, um den dauerhaften Modus zu beenden.</param>
+        void set_journal(journal* pJournal);
+        /// <summary>
+        /// Stellt die lebenden Nachrichten aus dem Journal wieder her und postet sie erneut.
+        /// </summary>
+        /// <returns>Die Anzahl wiederhergestellter Nachrichten.</returns>
+        size_t restoreMessages();
+
+        /// <summary>
+        /// Übergibt entfernte Nachrichten an einen reclaimer, der sie gesammelt außerhalb des Locks zerstört.
+        /// Ohne reclaimer werden sie nach dem Freigeben des Locks im aufrufenden Thread zerstört.
+        /// Der reclaimer gehört dem Aufrufer und muss den eventmanager überleben.
+        /// </summary>
+        /// <param name="pReclaimer">Der reclaimer oder nullptr.</param>
+        void set_reclaimer(reclaimer* pReclaimer);
+        /// <summary>
+        /// Zeichnet gepostete Nachrichten und die Ergebnisse der Handler-Aufrufe auf, etwa um den Verkehr später mit replayer nachzuspielen.
+        /// Der recorder gehört dem Aufrufer und muss den eventmanager überleben.
+        /// </summary>
+        /// <param name="pRecorder">Der recorder oder nullptr, um die Aufzeichnung zu beenden.</param>
+        void set_recorder(recorder* pRecorder);
+        /// <summary>
+        /// Schaltet die Zähler je Priorität ein (Ankünfte, Handler-Aufrufe, Handler-Dauer). Eingeschaltet wird jeder Handler-Aufruf gemessen.
+        /// </summary>
+        void set_statistics(bool enabled);
+        /// <summary>
+        /// Liest die Zähler je Priorität ohne Lock. Die Werte wachsen monoton, Raten ergeben sich aus der Differenz zweier Abfragen.
+        /// </summary>
+        void get_statistics(priority_stats& stats) const;
+
+        /// <summary>
+        /// Registriert einen Batch-Handler für alle Nachrichten mit der angegebenen Typkennung.
+        /// </summary>
+        /// <param name="typeTag">Die Typkennung (bei system_message die System-ID).</param>
+        /// <param name="func">Der Handler, der die Nachrichten blockweise erhält.</param>
+        /// <param name="maxBatch">Die maximale Anzahl Nachrichten pro Aufruf.</param>
+        /// <param name="maxLingerMs">Wie lange ein unvollständiger Block höchstens auf weitere Nachrichten wartet (0 = sofort).</param>
+        void registerBatchHandler(uint32_t typeTag, batch_func func, size_t maxBatch, uint64_t maxLingerMs);
+        /// <summary>
+        /// Entfernt den Batch-Handler der angegebenen Typkennung.
+        /// </summary>
+        /// <param name="typeTag">Die Typkennung.</param>
+        void unregisterBatchHandler(uint32_t typeTag);
+
+        /// <summary>
+        /// Trägt einen Handler in die Dispatch-Tabelle ein. Nachrichten mit dieser Typkennung werden dann
+        /// gruppiert über den Handler statt über onMessageProcess verarbeitet.
+        /// </summary>
+        /// <param name="typeTag">Die Typkennung (bei system_message die System-ID).</param>
+        /// <param name="func">Der Handler für diese Typkennung.</param>
+        void registerHandler(uint32_t typeTag, handler_func func);
+        /// <summary>
+        /// Trägt einen zur Übersetzungszeit bekannten Handler in die Dispatch-Tabelle ein.
+        /// </summary>
+        /// <typeparam name="TTag">Die Typkennung.</typeparam>
+        /// <typeparam name="TFunc">Der Handler für diese Typkennung.</typeparam>
+        template <uint32_t TTag, handler_func TFunc>
+        void registerHandler() {
+            registerHandler(TTag, TFunc);
+        }
+        /// <summary>
+        /// Entfernt den Handler der angegebenen Typkennung aus der Dispatch-Tabelle.
+        /// </summary>
+        /// <param name="typeTag">Die Typkennung.</param>
+        void unregisterHandler(uint32_t typeTag);
+
         size_t      get_messages() const;
+        /// <summary>
+        /// Gibt die höchste wartende Priorität (kleinster Wert) im Bereich [from, to] zurück, ohne den Lock zu nehmen. Laufende asynchrone
+        /// Nachrichten zählen erst mit ihrem Abschluss wieder als wartend, erledigte nur bis zum Aufräumen in endProcessMessages.
+        /// </summary>
+        /// <returns>Die Priorität oder -1, wenn im Bereich keine Nachricht wartet.</returns>
+        int         get_top_priority(int from = 0, int to = 255) const;
         message_ptr get_byID(id_type id, uint64_t maxTime);
 
+        /// <summary>
+        /// Gibt den zuletzt veröffentlichten Schnappschuss der wartenden Nachrichten zurück, ohne den Lock zu nehmen.
+        /// Nach einer Änderung der Warteschlange wird er beim nächsten Posten oder Zyklusende erneuert, höchstens alle set_snapshot_interval Millisekunden.
+        /// Ruht die Warteschlange danach, erneuert ihn der erste Aufruf nach Ablauf des Intervalls.
+        /// </summary>
+        /// <returns>Der Schnappschuss, nie nullptr.</returns>
+        std::shared_ptr<const queue_snapshot> get_snapshot() const;
+        /// <summary>
+        /// Setzt, wie oft höchstens ein neuer Schnappschuss veröffentlicht wird.
+        /// </summary>
+        /// <param name="ms">Der Mindestabstand in Millisekunden (0 = nach jeder Änderung).</param>
+        void set_snapshot_interval(uint64_t ms) { m_ulSnapshotInterval = ms; }
+
+        /// <summary>
+        /// Setzt, wie viele Folge-Nachrichten processMessages im selben Durchlauf verarbeitet. Nachrichten, die Handler während der Verarbeitung
+        /// posten, landen ohne Lock in einem Puffer des Threads und werden vom letzten endProcessMessages des Durchlaufs bzw. vom nächsten
+        /// exklusiven postMessage gesammelt eingereiht. Liegen sie im
+        /// Prioritätsbereich des Durchlaufs, werden bis zu limit davon direkt verarbeitet, ohne die Warteschlange zu berühren.
+        /// Nachrichten eines Kapazitätsbands ohne freien Platz werden nicht verkettet, sondern durchlaufen beim Einreihen dessen Strategie.
+        /// </summary>
+        /// <param name="limit">Die Anzahl Folge-Nachrichten je Durchlauf (0 = nur puffern, Standard).</param>
+        void set_chain_limit(size_t limit) { m_ulChainLimit = limit; }
+
+
+        /// <summary>
+        /// Wartet, bis im Prioritätsbereich [from, to] eine Nachricht wartet. Zunächst wird kurz gesponnen, danach geschlafen,
+        /// bis postMessage weckt. Die Spin-Dauer passt sich daran an, ob das Spinnen zuletzt Erfolg hatte.
+        /// </summary>
+        /// <param name="timeoutMs">Die maximale Wartezeit in Millisekunden (TIMEDLOCK_INFINITY_WAIT = unbegrenzt).</param>
+        /// <returns>Gibt true zurück, wenn eine Nachricht im Bereich wartet, false nach Ablauf der Wartezeit.</returns>
+        bool wait_for_messages(int from, int to, uint64_t timeoutMs);
+        /// <summary>
+        /// Abonniert den Prioritätsbereich [from, to] für einen Reaktor (epoll, WaitForMultipleObjects). Das Handle des Abonnements wird
+        /// beim ersten Eintreffen einer Nachricht im Bereich signalisiert, weitere Nachrichten lösen bis zu acknowledge kein Signal aus.
+        /// </summary>
+        /// <returns>Das Abonnement oder nullptr, wenn kein Handle angelegt werden konnte.</returns>
+        subscription_ptr subscribe(uint8_t from, uint8_t to);
+        /// <summary>
+        /// Setzt das Handle eines Abonnements nach dem Aufwachen zurück, vor dem Verarbeiten aufzurufen.
+        /// Warten im Bereich noch Nachrichten, wird sofort erneut signalisiert.
+        /// </summary>
+        void acknowledge(const subscription_ptr& sub);
+        /// <summary>
+        /// Beendet ein Abonnement.
+        /// </summary>
+        void unsubscribe(const subscription_ptr& sub);
 
         bool beginMessages();
         bool processMessages(int from, int to);
         bool processMessages(uint8_t prio);
+        /// <summary>
+        /// Bearbeitet höchstens maxMessages Nachrichten bzw. höchstens maxMicros Mikrosekunden lang und merkt sich die Stelle im Cursor.
+        /// Der nächste Aufruf, auch in einem späteren Verarbeitungszyklus, setzt hinter der zuletzt bearbeiteten Nachricht fort.
+        /// Hat ein Aufruf das Ende erreicht (cursor.complete), beginnt der nächste wieder von vorn. Gesammelte Batch- und Tabellen-Handler
+        /// laufen am Ende des Aufrufs und zählen zum Nachrichtenbudget, ihre Laufzeit kann das Zeitbudget überschreiten.
+        /// </summary>
+        /// <param name="cursor">Der Fortsetzungspunkt.</param>
+        /// <param name="maxMessages">Die maximale Anzahl bearbeiteter Nachrichten (0 = unbegrenzt).</param>
+        /// <param name="maxMicros">Die maximale Dauer in Mikrosekunden (0 = unbegrenzt).</param>
+        bool processMessages(int from, int to, process_cursor& cursor, size_t maxMessages, uint64_t maxMicros = 0);
         bool endProcessMessages();
+
+        /// <summary>
+        /// Meldet das Ergebnis einer asynchronen Verarbeitung. Wird über async_token::complete aufgerufen, aus jedem Thread erlaubt.
+        /// </summary>
+        /// <param name="msg">Die asynchron verarbeitete Nachricht.</param>
+        /// <param name="success">true, wenn die Nachricht erfolgreich verarbeitet wurde, andernfalls false.</param>
+        void completeMessage(const message_ptr& msg, bool success);
     protected:
         void discardMessage(const message_ptr& msg);
     private:
-        sorted_vector<message_ptr> m_vecMessages;
+        struct batch_handler {
+            batch_func func;
+            size_t maxBatch;
+            uint64_t maxLingerMs;
+        };
+        struct capacity_band {
+            uint8_t from;
+            uint8_t to;
+            size_t capacity;
+            shed_policy policy;
+            size_t count;
+        };
+        // Unter dem Lock entstandene Rückmeldung an eine Nachricht, zugestellt erst nach release
+        struct post_notice {
+            enum kind_type : uint8_t { post, discard, expire };
+            message_ptr msg;
+            kind_type kind;
+            bool accepted; // bWasAdd für onMessagePost
+        };
+        using batch_map = std::unordered_map<uint32_t, std::vector<message_ptr>>;
+        using dispatch_list = std::vector<std::pair<handler_func, message_ptr>>;
+
+        bool runMessages(int from, int to, process_cursor* cursor, size_t maxMessages, uint64_t maxMicros);
+        void flushBatches(batch_map& batches, uint64_t now);
+        void dispatchTable(dispatch_list& list);
+        void drainCompleted();
+        bool coalesceMessage(const message_ptr& msg);
+        post_result insertMessage(const message_ptr& msg, bool notify);
+        post_result admitMessage(const message_ptr& msg);
+        void runChained(int from, int to);
+        void mergeLocalPosts(std::vector<message_ptr>& garbage);
+        void insertHandoff();
+        void sweepMessages();
+        void tidyMessages();
+        void deliverNotices(std::vector<post_notice>& notices);
+        void trackMessage(uint8_t prio, int delta);
+        void notifyArrival(uint8_t prio);
+        uint64_t handlerStart() const;
+        uint64_t handlerCost(uint64_t start) const;
+        void accountPost(const message& msg);
+        void accountHandler(const message& msg, bool success, uint64_t cost);
+        std::shared_ptr<queue_snapshot> collectSnapshot(bool force);
+        void publishSnapshot(std::shared_ptr<queue_snapshot> snapshot);
+        void refreshSnapshot();
+        void commitJournal(bool force);
+        void unindexMessage(const message_ptr& msg);
+        void retireMessages(std::vector<message_ptr>& garbage);
+    private:
+        message_container m_vecMessages;
         std::vector<message_ptr> m_vecDiscards;
         timed_countlock m_ctLock;
+        std::unordered_map<uint32_t, batch_handler> m_mapBatches;
+        std::unordered_map<uint32_t, handler_func> m_mapHandlers;
+        std::unordered_map<uint64_t, message_ptr> m_mapCoalesce;
+        journal* m_pJournal;
+        reclaimer* m_pReclaimer;
+        recorder* m_pRecorder;
+        std::vector<message_ptr> m_vecGarbage; // Unter dem Lock entfernte Nachrichten, freigegeben nach release
+        std::vector<post_notice> m_vecNotices; // Unter dem Lock ausgelöste Rückmeldungen, zugestellt nach release
+        order_policy m_eOrder;
+        bool (*m_funcOrder)(const message_ptr&, const message_ptr&);
+        std::vector<capacity_band> m_vecBands;
+        int16_t m_aBandOf[256]; // Index in m_vecBands je Priorität, -1 = unbegrenzt
+        size_t m_aPrioCount[256]; // Wartende Nachrichten je Priorität
+        std::atomic<uint64_t> m_aPrioMask[4]; // Bit je Priorität mit bereiten Nachrichten (nicht erledigt, nicht laufend asynchron), ohne Lock lesbar
+        uint64_t m_ulRandom;
+        std::atomic<size_t> m_ulCount;
+        std::shared_ptr<const queue_snapshot> m_ptrSnapshot;
+        uint64_t m_ulSnapshotInterval;
+        std::atomic<uint64_t> m_ulSnapshotTime;
+        std::atomic<uint64_t> m_ulSnapshotVersion;
+        std::atomic<bool> m_bSnapshotDirty; // Warteschlange seit dem letzten Schnappschuss geändert
+        std::mutex m_mtxSnapshot; // Reihenfolge beim Veröffentlichen
+        size_t m_ulChainLimit;
+        std::mutex m_mtxHandoff;
+        std::vector<message_ptr> m_vecHandoff; // Gepufferte Folge-Nachrichten, die erst ein exklusiver Halter einreiht
+        std::atomic<bool> m_bHandoff;
+        std::atomic<bool> m_bSweep; // Ein endProcessMessages war nicht einziger Halter, das nächste exklusive postMessage räumt auf
+        std::vector<subscription_ptr> m_vecSubscriptions;
+        std::mutex m_mtxWait;
+        std::condition_variable m_cvWait;
+        std::atomic<uint32_t> m_uiWaiters; // Schlafende Threads in wait_for_messages
+        std::atomic<uint32_t> m_uiSpin;    // Aktuelle Spin-Dauer von wait_for_messages
+        std::atomic<bool> m_bStatistics;
+        std::atomic<uint64_t> m_aArrivals[256];
+        std::atomic<uint64_t> m_aProcessed[256];
+        std::atomic<uint64_t> m_aCostNs[256];
+        std::mutex m_mtxCompleted;
+        std::vector<std::pair<message_ptr, bool>> m_vecCompleted;
+        std::shared_ptr<async_link> m_ptrAsync; // Verbindung der ausgegebenen async_token, clearMessages ersetzt sie
     };
 }
 
@@ -0,0 +1,56 @@
+// SPDX-License-Identifier: EUPL-1.2
+
+#pragma once
+
+#include "message.h"
+
+namespace ses {
+
+	/// <summary>
+	/// Verweis auf eine Nachricht, die an mehrere eventmanager verteilt wird (siehe eventbus). Die Nutzdaten werden nicht kopiert,
+	/// jede Kopie hat aber einen eigenen Verarbeitungszustand. Priorität, Lebensdauer, ID und Typkennung werden übernommen,
+	/// Handler der Dispatch-Tabelle erhalten die eigentliche Nachricht. Verarbeitung, Verwerfen und Ablauf werden je Kopie an die
+	/// Nachricht weitergereicht, onMessagePost erhält die Nachricht nur von ihrem ersten Ziel.
+	/// </summary>
+	class SES_API forward_message : public message {
+	public:
+		/// <summary>
+		/// Konstruiert eine weitergeleitete Kopie.
+		/// </summary>
+		/// <param name="payload">Die eigentliche Nachricht, sie darf selbst keine forward_message sein.</param>
+		explicit forward_message(std::shared_ptr<message> payload)
+			: message(*payload), m_ptrPayload(std::move(payload)) {
+			m_ucFlags = flag_forward;
+			m_iCount = 0;
+		}
+
+		virtual bool onMessageProcess(void* sender) { return m_ptrPayload->onMessageProcess(sender); }
+		virtual void onMessageExpired(void* sender, uint64_t time) { m_ptrPayload->onMessageExpired(sender, time); }
+		virtual void onMessageDiscard(void* sender, uint64_t time) { m_ptrPayload->onMessageDiscard(sender, time); }
+		virtual void onMessagePost(void* /*sender*/, bool /*bWasAdd*/) {}
+
+		virtual bool is_expired(uint64_t now) const { return m_ptrPayload->is_expired(now); }
+		virtual bool serialize(std::vector<uint8_t>& out) const { return m_ptrPayload->serialize(out); }
+		virtual uint64_t get_coalescekey() const { return m_ptrPayload->get_coalescekey(); }
+
+		/// <summary>
+		/// Gibt die eigentliche Nachricht zurück.
+		/// </summary>
+		const std::shared_ptr<message>& get_payload() const { return m_ptrPayload; }
+
+		/// <summary>
+		/// Gibt bei einer forward_message die eigentliche Nachricht zurück, sonst msg selbst.
+		/// </summary>
+		static message& payload_of(message& msg) {
+			return msg.is_forward() ? *static_cast<forward_message&>(msg).m_ptrPayload : msg;
+		}
+		/// <summary>
+		/// Gibt bei einer forward_message den Zeiger auf die eigentliche Nachricht zurück, sonst msg selbst.
+		/// </summary>
+		static const std::shared_ptr<message>& payload_of(const std::shared_ptr<message>& msg) {
+			return msg->is_forward() ? static_cast<forward_message&>(*msg).m_ptrPayload : msg;
+		}
+	private:
+		std::shared_ptr<message> m_ptrPayload;
+	};
+}
@@ -0,0 +1,133 @@
+// SPDX-License-Identifier: EUPL-1.2
+
+#pragma once
+
+#include "message.h"
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ses {
+
+    /// <summary>
+    /// Write-Ahead-Journal für wartende Nachrichten. Gepostete Nachrichten werden als kompakter Binärsatz in
+    /// speicherabgebildete Segmentdateien geschrieben, abgeschlossene Nachrichten erhalten einen Grabstein.
+    /// Nach einem Neustart liefert replay nur die noch lebenden Nachrichten. Segmente ohne lebende Einträge werden gelöscht.
+    /// </summary>
+    class SES_API journal {
+    public:
+        using message_ptr = std::shared_ptr<message>;
+        /// <summary>
+        /// Erzeugt eine Nachricht aus ihren serialisierten Nutzdaten (siehe message::serialize).
+        /// </summary>
+        using factory_func = std::function<message_ptr(const uint8_t* data, size_t size)>;
+
+        /// <summary>
+        /// Konstruiert ein Journal im angegebenen Verzeichnis.
+        /// </summary>
+        /// <param name="directory">Das Verzeichnis der Segmentdateien.</param>
+        /// <param name="segmentSize">Die Größe einer Segmentdatei in Bytes (Standard: 4 MiB).</param>
+        /// <param name="groupCommit">Die Anzahl Sätze, nach der spätestens auf das Medium geschrieben wird (Standard: 64).</param>
+        journal(const std::string& directory, size_t segmentSize = 4 * 1024 * 1024, size_t groupCommit = 64);
+        ~journal();
+
+        journal(const journal&) = delete;
+        journal& operator=(const journal&) = delete;
+
+        /// <summary>
+        /// Registriert die Fabrik für eine Typkennung, mit der replay die Nachrichten wiederherstellt.
+        /// </summary>
+        /// <param name="typeTag">Die Typkennung der Nachricht.</param>
+        /// <param name="func">Die Fabrikfunktion.</param>
+        void register_type(uint32_t typeTag, factory_func func);
+
+        /// <summary>
+        /// Hängt einen Satz für eine gepostete Nachricht an. Nachrichten ohne Serialisierung werden nicht aufgezeichnet.
+        /// </summary>
+        /// <param name="msg">Die gepostete Nachricht.</param>
+        /// <returns>Gibt true zurück, wenn die Nachricht aufgezeichnet wurde, andernfalls false.</returns>
+        bool appendPost(const message& msg);
+        /// <summary>
+        /// Hängt einen Grabstein für eine abgeschlossene oder verworfene Nachricht an. Der Grabstein verweist auf die
+        /// Satznummer des Postsatzes, nicht auf die ID, da IDs in jedem Prozess neu beginnen.
+        /// </summary>
+        /// <param name="msg">Die Nachricht, die zuvor mit appendPost aufgezeichnet wurde.</param>
+        void appendTombstone(const message& msg);
+        /// <summary>
+        /// Schreibt alle noch nicht gesicherten Sätze auf das Medium (Group Commit). Das Schreiben selbst läuft ohne den
+        /// Journal-Lock, gleichzeitiges Anhängen wird nicht aufgehalten.
+        /// </summary>
+        void commit();
+        /// <summary>
+        /// Prüft, ob ein Commit fällig ist: groupCommit Sätze sind ungesichert oder der älteste ungesicherte Satz hat das
+        /// Commit-Intervall überschritten. Anhängen schreibt selbst nicht auf das Medium, der Aufrufer ruft danach commit auf.
+        /// </summary>
+        /// <returns>Gibt true zurück, wenn commit aufgerufen werden sollte, andernfalls false.</returns>
+        bool is_commit_due();
+        /// <summary>
+        /// Setzt die maximale Zeit, die ein Satz ungesichert bleiben soll (Standard: 10 ms).
+        /// </summary>
+        /// <param name="intervalMs">Das Intervall in Millisekunden.</param>
+        void set_commit_interval(uint64_t intervalMs);
+
+        /// <summary>
+        /// Liest alle Segmente und liefert die noch lebenden Nachrichten in Postreihenfolge.
+        /// Die gelesenen Segmente bleiben bestehen, bis drop_replayed aufgerufen wird.
+        /// </summary>
+        /// <returns>Die wiederhergestellten Nachrichten.</returns>
+        std::vector<message_ptr> replay();
+        /// <summary>
+        /// Löscht die von replay gelesenen Segmente, nachdem die Nachrichten erneut gepostet und gesichert wurden.
+        /// </summary>
+        void drop_replayed();
+
+        /// <summary>
+        /// Gibt die Anzahl lebender aufgezeichneter Nachrichten zurück.
+        /// </summary>
+        /// <returns>Die Anzahl als size_t.</returns>
+        size_t get_live() const { return m_mapLive.size(); }
+    private:
+        struct segment {
+            uint64_t sequence;
+            std::string path;
+            uint8_t* data;
+            size_t live;
+            intptr_t file;
+            void* mapping;
+        };
+
+        struct live_record {
+            uint64_t record;    // Satznummer des Postsatzes
+            uint64_t sequence;  // Sequenz des Segments mit dem Postsatz
+        };
+
+        bool openSegment();
+        void closeSegment(segment& seg, bool remove);
+        bool appendRecord(uint8_t kind, const message& msg, const uint8_t* payload, uint32_t size);
+        void flush();
+        void trimSegments();
+        std::string segmentPath(uint64_t sequence) const;
+        std::vector<uint64_t> listSegments() const;
+    private:
+        std::string m_strDirectory;
+        size_t m_ulSegmentSize;
+        size_t m_ulGroupCommit;
+        std::mutex m_mtxJournal;
+        std::mutex m_mtxCommit;             // Hält gleichzeitige commit-Aufrufe in Reihenfolge
+        std::vector<segment> m_vecSegments; // Offene Segmente, das letzte ist das aktuelle
+        std::unordered_map<const message*, live_record> m_mapLive; // Lebende aufgezeichnete Nachrichten
+        std::unordered_map<uint32_t, factory_func> m_mapFactories;
+        std::vector<uint64_t> m_vecReplayed;
+        uint64_t m_ulNextSequence;
+        uint64_t m_ulNextRecord;            // Satznummer: Sequenz des Segments << 32 | laufende Nummer im Segment
+        size_t m_ulWriteOffset;
+        size_t m_ulFlushOffset;
+        size_t m_ulUncommitted;
+        uint64_t m_ulCommitInterval;
+        uint64_t m_ulFirstUncommitted;      // tool::now() des ältesten ungesicherten Satzes
+        bool m_bCommitting;                 // commit schreibt gerade ohne Lock, Segmente dürfen nicht geschlossen werden
+    };
+}
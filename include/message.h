@@ -1,6 +1,6 @@
 /**
 * SES Smart Event System
-* (c) 2025 Amber-Sophia Schrck
+* (c) 2025 Amber-Sophia Schröck
 * This file is copyright under the latest version of the EUPL.
 * Please see LICENSE file for your rights under this license.
 **/
@@ -12,12 +12,34 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <utility>
+#include <algorithm>
 #include <chrono>
 #include "tool.h"
 
 namespace ses {
     /// <summary>
-    /// Die Klasse "message" reprsentiert eine Nachricht mit Zeitstempel, Prioritt, Lebensdauer und eindeutiger ID. Sie bietet Methoden zur Verwaltung und Verarbeitung von Nachrichten, einschlielich Ablaufprfung, Verwerfungszhler und Priorittssteuerung.
+    /// Ergebnis von eventmanager::postMessage. Wird vor onMessagePost an der Nachricht gesetzt und kann dort über get_postresult abgefragt werden.
+    /// </summary>
+    enum class post_result : uint8_t {
+        /// <summary>Die Nachricht wurde eingefügt.</summary>
+        added = 0,
+        /// <summary>Die Nachricht hat eine wartende Nachricht mit gleichem Schlüssel ersetzt.</summary>
+        coalesced,
+        /// <summary>Der Lock konnte nicht innerhalb der Wartezeit erlangt werden.</summary>
+        timeout,
+        /// <summary>Das Prioritätsband ist voll, die Nachricht wurde abgelehnt.</summary>
+        capacity,
+        /// <summary>Die Nachricht wurde durch vorzeitiges Verwerfen (early drop) abgelehnt.</summary>
+        dropped,
+        /// <summary>Die Nachricht wurde nachträglich zugunsten einer wichtigeren Nachricht entfernt.</summary>
+        evicted,
+        /// <summary>Die Nachricht wurde aus einem Handler gepostet und liegt im lokalen Puffer des verarbeitenden Threads. Sie wird in endProcessMessages eingereiht, onMessagePost folgt dann mit dem endgültigen Ergebnis.</summary>
+        deferred
+    };
+
+    /// <summary>
+    /// Die Klasse "message" repräsentiert eine Nachricht mit Zeitstempel, Priorität, Lebensdauer und eindeutiger ID. Sie bietet Methoden zur Verwaltung und Verarbeitung von Nachrichten, einschließlich Ablaufprüfung, Verwerfungszähler und Prioritätssteuerung.
     /// </summary>
     class SES_API message {
     public:
@@ -41,7 +63,7 @@ namespace ses {
                     uint32_t rid : 30;
                 };
                 /// <summary>
-                /// De rawid der nachruht
+                /// Díe rawid der nachruht
                 /// </summary>
                 uint32_t full;
 
@@ -53,17 +75,17 @@ namespace ses {
             explicit id(uint32_t raw = 0) : rid(raw) {}
 
             /// <summary>
-            /// Prft, ob die Nachricht intern ist.
+            /// Prüft, ob die Nachricht intern ist.
             /// </summary>
-            /// <returns>Gibt true zurck, wenn msg gleich 1 ist, andernfalls false.</returns>
+            /// <returns>Gibt true zurück, wenn msg gleich 1 ist, andernfalls false.</returns>
             bool is_internal() const { return msg == 1; }
             /// <summary>
-            /// Prft, ob es sich um eine Gruppe handelt.
+            /// Prüft, ob es sich um eine Gruppe handelt.
             /// </summary>
-            /// <returns>Gibt true zurck, wenn gr gleich 1 ist, andernfalls false.</returns>
+            /// <returns>Gibt true zurück, wenn gr gleich 1 ist, andernfalls false.</returns>
             bool is_group() const { return gr == 1; }
             /// <summary>
-            /// Gibt die rohe ID zurck.
+            /// Gibt die rohe ID zurück.
             /// </summary>
             /// <returns>Die gespeicherte Roh-ID als uint32_t.</returns>
             uint32_t raw_id() const { return rid; }
@@ -72,11 +94,11 @@ namespace ses {
         friend class eventmanager;
 
         /// <summary>
-        /// Definiert einen Aliasnamen fr den Typ 'id'.
+        /// Definiert einen Aliasnamen für den Typ 'id'.
         /// </summary>
         using id_type = id;
 		/// <summary>
-		/// Definiert einen Alias fr einen gemeinsam genutzten Zeiger auf ein message-Objekt.
+		/// Definiert einen Alias für einen gemeinsam genutzten Zeiger auf ein message-Objekt.
 		/// </summary>
 		using pointer_type = message*;
 
@@ -85,14 +107,16 @@ namespace ses {
         /// </summary>
         message() : message(5, 0) { }
 		/// <summary>
-		/// Konstruiert ein message-Objekt mit Prioritt, Zeitstempel und optionalen Einstellungen fr System- und Gruppennachrichten.
+		/// Konstruiert ein message-Objekt mit Priorität, Zeitstempel und optionalen Einstellungen für System- und Gruppennachrichten.
 		/// </summary>
-		/// <param name="prio">Die Prioritt der Nachricht als 8-Bit-Ganzzahl.</param>
+		/// <param name="prio">Die Priorität der Nachricht als 8-Bit-Ganzzahl.</param>
 		/// <param name="ms">Die Lebensdauer der Nachricht in Millisekunden (Standardwert: 1000).</param>
 		/// <param name="bIsSystem">Gibt an, ob es sich um eine Systemnachricht handelt (Standardwert: false).</param>
 		/// <param name="bIsGroup">Gibt an, ob es sich um eine Gruppennachricht handelt (Standardwert: false).</param>
 		message(uint8_t prio, uint32_t ms = 1000, bool bIsSystem = false, bool bIsGroup = false) 
-            : m_iCount(0), m_uiTimeStamp(tool::now()), m_uiAliveMs(ms), m_ucPriority(prio), m_id(message::get_nextid(bIsSystem, bIsGroup) ) , m_iMaxCount(5){ }
+            : m_uiAliveMs(ms), m_id(message::get_nextid(bIsSystem, bIsGroup)), m_uiTypeTag(0), m_ucPriority(prio), m_iCount(0), m_iMaxCount(5), m_ucFlags(0) { 
+            set_timestamp(tool::now());
+        }
 
 		message(const message& other) = default;
 		message(message&& other) = default;
@@ -102,90 +126,131 @@ namespace ses {
         /// Wird aufgerufen, nachdem eine Nachricht gepostet wurde.
         /// </summary>
         /// <param name="sender">Ein Zeiger auf das Objekt, das die Nachricht gesendet hat.</param>
-        /// <param name="bWasAdd">Gibt an, ob die Nachricht hinzugefgt (true) wrde oder fehler passierte zb Zeit abgelafen (false).</param>
+        /// <param name="bWasAdd">Gibt an, ob die Nachricht hinzugefügt (true) würde oder fehler passierte zb Zeit abgelafen (false).</param>
         virtual void onMessagePost(void* sender, bool bWasAdd) = 0;
         /// <summary>
         /// Wird aufgerufen, um eine Nachricht zu verarbeiten.
         /// </summary>
         /// <param name="sender">Ein Zeiger auf das Objekt, das die Nachricht gesendet hat.</param>
-        /// <returns>Gibt true zurck, wenn die Nachricht erfolgreich verarbeitet wurde, andernfalls false.</returns>
+        /// <returns>Gibt true zurück, wenn die Nachricht erfolgreich verarbeitet wurde, andernfalls false.</returns>
         virtual bool onMessageProcess(void* sender) = 0;
         /// <summary>
         /// Wird aufgerufen, wenn eine Nachricht verworfen wird.
         /// </summary>
-        /// <param name="sender">Ein Zeiger auf das Objekt, das das Ereignis ausgelst hat.</param>
+        /// <param name="sender">Ein Zeiger auf das Objekt, das das Ereignis ausgelöst hat.</param>
         /// <param name="time">Der Zeitstempel (in Mikrosekunden), zu dem die Nachricht verworfen wurde.</param>
         virtual void onMessageDiscard(void* sender, uint64_t time) = 0;
         /// <summary>
         /// Wird aufgerufen, wenn eine Nachricht abgelaufen ist.
         /// </summary>
-        /// <param name="sender">Ein Zeiger auf das Objekt, das das Ereignis ausgelst hat.</param>
+        /// <param name="sender">Ein Zeiger auf das Objekt, das das Ereignis ausgelöst hat.</param>
         /// <param name="time">Der Zeitpunkt (in Millisekunden seit Epoche), zu dem die Nachricht abgelaufen ist.</param>
         virtual void onMessageExpired(void* sender, uint64_t time) = 0;
         
         /// <summary>
-        /// Prft, ob ein Objekt abgelaufen ist.
+        /// Prüft, ob ein Objekt abgelaufen ist.
         /// </summary>
         /// <param name="now">Der aktuelle Zeitstempel in Millisekunden.</param>
-        /// <returns>Gibt true zurck, wenn das Objekt abgelaufen ist, andernfalls false.</returns>
+        /// <returns>Gibt true zurück, wenn das Objekt abgelaufen ist, andernfalls false.</returns>
         virtual bool is_expired(uint64_t now) const {
-            return m_uiAliveMs > 0 && now > (m_uiTimeStamp + m_uiAliveMs);
+            return m_uiAliveMs > 0 && now > (get_timestamp() + m_uiAliveMs);
         }
         /// <summary>
-        /// Prft, ob die maximale Anzahl erreicht oder berschritten wurde.
+        /// Serialisiert die Nutzdaten der Nachricht für das Journal. Nachrichten ohne Serialisierung werden nicht aufgezeichnet.
         /// </summary>
-        /// <returns>Gibt true zurck, wenn m_iCount grer oder gleich m_iMaxCount ist, andernfalls false.</returns>
+        /// <param name="out">Der Puffer, an den die Nutzdaten angehängt werden.</param>
+        /// <returns>Gibt true zurück, wenn die Nachricht serialisiert wurde, andernfalls false.</returns>
+        virtual bool serialize(std::vector<uint8_t>& /*out*/) const { return false; }
+        /// <summary>
+        /// Prüft, ob die maximale Anzahl erreicht oder überschritten wurde.
+        /// </summary>
+        /// <returns>Gibt true zurück, wenn m_iCount größer oder gleich m_iMaxCount ist, andernfalls false.</returns>
         bool is_maxDiscard() const { 
             return m_iCount >= m_iMaxCount; 
         }
         /// <summary>
-        /// Gibt den Zeitstempel zurck.
+        /// Gibt den Zeitstempel zurück.
         /// </summary>
         /// <returns>Der aktuelle Zeitstempel als uint64_t-Wert.</returns>
+#ifdef SES_COMPACT_TIMESTAMP
+        uint64_t get_timestamp() const { return time_base() + m_iTimeStamp; }
+#else
         uint64_t get_timestamp() const { return m_uiTimeStamp; }
+#endif
         /// <summary>
-        /// Gibt die Anzahl wie oft die Nachricht verworfen wrde
+        /// Gibt die Anzahl wie oft die Nachricht verworfen würde
         /// </summary>
-        /// <returns>Die Anzahl wie oft die Nachricht verworfen wrde als uint32_t.</returns>
+        /// <returns>Die Anzahl wie oft die Nachricht verworfen würde als uint32_t.</returns>
         uint32_t get_discards() const { return m_iCount; }
         /// <summary>
-        /// Gibt die Anzahl der Millisekunden zurck, wie lange de Nachrcht lebt
+        /// Gibt die Anzahl der Millisekunden zurück, wie lange díe Nachrcht lebt
         /// </summary>
         /// <returns>Die Anzahl der Millisekunden, die das Objekt aktiv ist (als uint32_t).</returns>
         uint32_t get_alivems() const { return m_uiAliveMs; }
         /// <summary>
-        /// Gibt die Prioritt zurck.
+        /// Gibt die Priorität zurück.
         /// </summary>
-        /// <returns>Die Prioritt als uint8_t-Wert.</returns>
+        /// <returns>Die Priorität als uint8_t-Wert.</returns>
         uint8_t  get_priority() const { return m_ucPriority; }
         /// <summary>
-        /// Gibt die aktuelle ID zurck.
+        /// Gibt die aktuelle ID zurück.
         /// </summary>
         /// <returns>Die aktuelle ID des Objekts.</returns>
         id_type  get_id() const { return m_id; }
+        /// <summary>
+        /// Gibt die Typkennung der Nachricht zurück, über die Batch-Handler zugeordnet werden.
+        /// </summary>
+        /// <returns>Die Typkennung als uint32_t (0 = keine).</returns>
+        uint32_t get_typetag() const { return m_uiTypeTag; }
+        /// <summary>
+        /// Gibt den Zusammenfassungsschlüssel der Nachricht zurück. Eine noch wartende Nachricht mit demselben Schlüssel wird beim Posten
+        /// durch diese Nachricht ersetzt (last writer wins). Nachrichtentypen, die zusammengefasst werden, überschreiben die Methode,
+        /// z. B. mit der ID der betroffenen Entität; der Schlüssel belegt so keinen Platz im Kopf jeder Nachricht.
+        /// </summary>
+        /// <returns>Der Schlüssel als uint64_t (0 = keine Zusammenfassung).</returns>
+        virtual uint64_t get_coalescekey() const { return 0; }
+        /// <summary>
+        /// Gibt den Grund des letzten Ergebnisses von postMessage zurück.
+        /// </summary>
+        /// <returns>Das Ergebnis als post_result.</returns>
+        post_result get_postresult() const { return static_cast<post_result>((m_ucFlags & flag_result) >> 4); }
 
 		/// <summary>
 		/// Setzt den Zeitstempel auf den angegebenen Wert.
 		/// </summary>
 		/// <param name="ts">Der neue Zeitstempelwert, der gesetzt werden soll.</param>
+#ifdef SES_COMPACT_TIMESTAMP
+		void set_timestamp(uint64_t ts) {
+            // Außerhalb von etwa ±24 Tagen um time_base() wird auf den darstellbaren Bereich begrenzt, nach unten höchstens bis 0
+            int64_t rel = static_cast<int64_t>(ts - time_base());
+            int64_t low = std::max<int64_t>(INT32_MIN, -static_cast<int64_t>(time_base()));
+            m_iTimeStamp = static_cast<int32_t>((rel < low) ? low : (rel > INT32_MAX) ? INT32_MAX : rel);
+        }
+#else
 		void set_timestamp(uint64_t ts) { m_uiTimeStamp = ts; }
+#endif
 		/// <summary>
 		/// Setzt die Alive-Zeit in Millisekunden.
 		/// </summary>
 		/// <param name="ms">Die Anzahl der Millisekunden, die als Alive-Zeit gesetzt werden soll.</param>
 		void set_alivems(uint32_t ms) { m_uiAliveMs = ms; }
         /// <summary>
-        /// Setzt die Prioritt auf den angegebenen Wert.
+        /// Setzt die Priorität auf den angegebenen Wert.
         /// </summary>
-        /// <param name="priority">Der zu setzende Priorittswert.</param>
+        /// <param name="priority">Der zu setzende Prioritätswert.</param>
         void set_priority(uint8_t priority) { m_ucPriority = priority; }
         /// <summary>
+        /// Setzt die Typkennung der Nachricht.
+        /// </summary>
+        /// <param name="tag">Die neue Typkennung (0 = keine).</param>
+        void set_typetag(uint32_t tag) { m_uiTypeTag = tag; }
+        /// <summary>
         /// Setzt die maximale Anzahl wie oft diese Nachricht werworfen werden darf, bis sie als abgelaufen gilt.
         /// </summary>
         /// <param name="max">Die maximale Anzahl der zu verwerfenden Elemente.</param>
         void set_maxdiscards(uint8_t max) { m_iMaxCount = max;  }
         /// <summary>
-        /// Erhht den internen Zhler um eins, um einen Verwerfungszustand zu setzen.
+        /// Erhöht den internen Zähler um eins, um einen Verwerfungszustand zu setzen.
         /// </summary>
         void set_discard() {  m_iCount++;  }
 
@@ -198,10 +263,11 @@ namespace ses {
         message& operator=(const message& other) {
             if (this != &other) {
                 m_iCount = other.m_iCount;
-                m_uiTimeStamp = other.m_uiTimeStamp;
+                set_timestamp(other.get_timestamp());
                 m_uiAliveMs = other.m_uiAliveMs;
                 m_ucPriority = other.m_ucPriority;
                 m_id = other.m_id;
+                m_uiTypeTag = other.m_uiTypeTag;
             }
             return *this;
         }
@@ -209,15 +275,15 @@ namespace ses {
         /// Vergleicht zwei message-Objekte auf Gleichheit anhand ihrer m_id.full-Werte.
         /// </summary>
         /// <param name="other">Das message-Objekt, mit dem verglichen wird.</param>
-        /// <returns>Gibt true zurck, wenn beide message-Objekte denselben m_id.full-Wert haben, andernfalls false.</returns>
+        /// <returns>Gibt true zurück, wenn beide message-Objekte denselben m_id.full-Wert haben, andernfalls false.</returns>
         bool operator==(const message& other) const {
             return m_id.full == other.m_id.full;
 		}
         /// <summary>
-        /// Prft, ob zwei message-Objekte ungleich sind.
+        /// Prüft, ob zwei message-Objekte ungleich sind.
         /// </summary>
         /// <param name="other">Das message-Objekt, mit dem verglichen wird.</param>
-        /// <returns>Gibt true zurck, wenn die beiden message-Objekte nicht gleich sind, andernfalls false.</returns>
+        /// <returns>Gibt true zurück, wenn die beiden message-Objekte nicht gleich sind, andernfalls false.</returns>
         bool operator!=(const message& other) const {
             return !(*this == other);
         }
@@ -225,15 +291,15 @@ namespace ses {
         /// Vergleicht zwei message-Objekte anhand ihrer m_id.full-Werte.
         /// </summary>
         /// <param name="other">Das message-Objekt, mit dem verglichen wird.</param>
-        /// <returns>Gibt true zurck, wenn das aktuelle message-Objekt einen kleineren m_id.full-Wert als other hat, andernfalls false.</returns>
+        /// <returns>Gibt true zurück, wenn das aktuelle message-Objekt einen kleineren m_id.full-Wert als other hat, andernfalls false.</returns>
         bool operator<(const message& other) const {
             return m_id.full < other.m_id.full;
 		}
         /// <summary>
-        /// Vergleicht, ob die ID dieser Nachricht grer als die ID einer anderen Nachricht ist.
+        /// Vergleicht, ob die ID dieser Nachricht größer als die ID einer anderen Nachricht ist.
         /// </summary>
         /// <param name="other">Die andere Nachricht, mit der verglichen wird.</param>
-        /// <returns>Gibt true zurck, wenn die ID dieser Nachricht grer als die der anderen Nachricht ist, andernfalls false.</returns>
+        /// <returns>Gibt true zurück, wenn die ID dieser Nachricht größer als die der anderen Nachricht ist, andernfalls false.</returns>
         bool operator>(const message& other) const {
             return m_id.full > other.m_id.full;
         }
@@ -241,15 +307,15 @@ namespace ses {
         /// Vergleicht, ob die aktuelle Nachricht kleiner oder gleich einer anderen Nachricht ist.
         /// </summary>
         /// <param name="other">Die andere Nachricht, mit der verglichen wird.</param>
-        /// <returns>Gibt true zurck, wenn die aktuelle Nachricht kleiner oder gleich der anderen Nachricht ist, andernfalls false.</returns>
+        /// <returns>Gibt true zurück, wenn die aktuelle Nachricht kleiner oder gleich der anderen Nachricht ist, andernfalls false.</returns>
         bool operator<=(const message& other) const {
             return m_id.full <= other.m_id.full;
         }
         /// <summary>
-        /// Vergleicht, ob die aktuelle Nachricht grer oder gleich einer anderen Nachricht ist.
+        /// Vergleicht, ob die aktuelle Nachricht größer oder gleich einer anderen Nachricht ist.
         /// </summary>
         /// <param name="other">Die andere Nachricht, mit der verglichen wird.</param>
-        /// <returns>Gibt true zurck, wenn die aktuelle Nachricht grer oder gleich der anderen Nachricht ist, andernfalls false.</returns>
+        /// <returns>Gibt true zurück, wenn die aktuelle Nachricht größer oder gleich der anderen Nachricht ist, andernfalls false.</returns>
         bool operator>=(const message& other) const {
             return m_id.full >= other.m_id.full;
 		}
@@ -257,15 +323,15 @@ namespace ses {
         /// Vergleicht, ob zwei id_type-Objekte gleich sind.
         /// </summary>
         /// <param name="other">Das andere id_type-Objekt, mit dem verglichen wird.</param>
-        /// <returns>Gibt true zurck, wenn beide id_type-Objekte gleich sind, andernfalls false.</returns>
+        /// <returns>Gibt true zurück, wenn beide id_type-Objekte gleich sind, andernfalls false.</returns>
         bool operator==(const id_type& other) const {
             return m_id.full == other.full;
         }
         /// <summary>
-        /// Prft, ob zwei id_type-Objekte ungleich sind.
+        /// Prüft, ob zwei id_type-Objekte ungleich sind.
         /// </summary>
         /// <param name="other">Das zu vergleichende id_type-Objekt.</param>
-        /// <returns>Gibt true zurck, wenn die beiden Objekte ungleich sind, andernfalls false.</returns>
+        /// <returns>Gibt true zurück, wenn die beiden Objekte ungleich sind, andernfalls false.</returns>
         bool operator!=(const id_type& other) const {
             return !(*this == other);
         }
@@ -273,15 +339,15 @@ namespace ses {
         /// Vergleicht zwei id_type-Objekte auf Grundlage ihres full-Mitglieds.
         /// </summary>
         /// <param name="other">Das id_type-Objekt, mit dem verglichen wird.</param>
-        /// <returns>Gibt true zurck, wenn das full-Mitglied dieses Objekts kleiner als das von other ist, andernfalls false.</returns>
+        /// <returns>Gibt true zurück, wenn das full-Mitglied dieses Objekts kleiner als das von other ist, andernfalls false.</returns>
         bool operator<(const id_type& other) const {
             return m_id.full < other.full;
         }
         /// <summary>
-        /// Vergleicht, ob die aktuelle id_type-Instanz grer als eine andere ist.
+        /// Vergleicht, ob die aktuelle id_type-Instanz größer als eine andere ist.
         /// </summary>
         /// <param name="other">Die andere id_type-Instanz, mit der verglichen wird.</param>
-        /// <returns>Gibt true zurck, wenn die aktuelle Instanz grer als other ist, andernfalls false.</returns>
+        /// <returns>Gibt true zurück, wenn die aktuelle Instanz größer als other ist, andernfalls false.</returns>
         bool operator>(const id_type& other) const {
             return m_id.full > other.full;
         }
@@ -289,27 +355,69 @@ namespace ses {
         /// Vergleicht, ob die aktuelle id_type-Instanz kleiner oder gleich einer anderen ist.
         /// </summary>
         /// <param name="other">Das andere id_type-Objekt, mit dem verglichen wird.</param>
-        /// <returns>Gibt true zurck, wenn die aktuelle Instanz kleiner oder gleich other ist, andernfalls false.</returns>
+        /// <returns>Gibt true zurück, wenn die aktuelle Instanz kleiner oder gleich other ist, andernfalls false.</returns>
         bool operator<=(const id_type& other) const {
             return m_id.full <= other.full;
         }
         /// <summary>
-        /// Vergleicht, ob die aktuelle id_type-Instanz grer oder gleich einer anderen ist.
+        /// Vergleicht, ob die aktuelle id_type-Instanz größer oder gleich einer anderen ist.
         /// </summary>
         /// <param name="other">Die andere id_type-Instanz, mit der verglichen wird.</param>
-        /// <returns>Gibt true zurck, wenn die aktuelle Instanz grer oder gleich der anderen ist, andernfalls false.</returns>
+        /// <returns>Gibt true zurück, wenn die aktuelle Instanz größer oder gleich der anderen ist, andernfalls false.</returns>
         bool operator>=(const id_type& other) const {
             return m_id.full >= other.full;
 		}
-        void set_runned() { m_bMarked = true; }
-        bool is_marked() { return m_bMarked; }
+        void set_runned() { set_flag(flag_marked, true); }
+        bool is_marked() { return (m_ucFlags & flag_marked) != 0; }
+        /// <summary>
+        /// Prüft, ob die Nachricht asynchron verarbeitet wird (siehe async_message).
+        /// </summary>
+        /// <returns>Gibt true zurück, wenn die Nachricht asynchron verarbeitet wird, andernfalls false.</returns>
+        bool is_async() const { return (m_ucFlags & flag_async) != 0; }
+        /// <summary>
+        /// Prüft, ob eine asynchrone Verarbeitung der Nachricht noch läuft.
+        /// </summary>
+        /// <returns>Gibt true zurück, wenn die Verarbeitung noch nicht abgeschlossen ist, andernfalls false.</returns>
+        bool is_pending() const { return (m_ucFlags & flag_pending) != 0; }
+        /// <summary>
+        /// Prüft, ob die Nachricht eine weitergeleitete Kopie ist (siehe forward_message).
+        /// </summary>
+        /// <returns>Gibt true zurück, wenn die Nachricht nur auf eine andere Nachricht verweist, andernfalls false.</returns>
+        bool is_forward() const { return (m_ucFlags & flag_forward) != 0; }
+
+#ifdef SES_COMPACT_TIMESTAMP
+        /// <summary>
+        /// Bezugszeitpunkt der relativen Zeitstempel: tool::now() beim ersten Aufruf im Prozess.
+        /// </summary>
+        static uint64_t time_base() {
+            static const uint64_t base = tool::now();
+            return base;
+        }
+#endif
+    protected:
+        /// <summary>
+        /// Zustandsbits in m_ucFlags.
+        /// </summary>
+        enum : uint8_t {
+            flag_marked = 0x01,  // Verarbeitet oder abgelaufen, wird beim nächsten endProcessMessages entfernt
+            flag_async = 0x02,   // Verarbeitung über async_message::onMessageProcessAsync
+            flag_pending = 0x04, // Asynchrone Verarbeitung läuft
+            flag_forward = 0x08, // forward_message, verweist auf die eigentliche Nachricht
+            flag_result = 0x70   // post_result des letzten postMessage
+        };
+        void set_flag(uint8_t flag, bool value) {
+            m_ucFlags = value ? static_cast<uint8_t>(m_ucFlags | flag) : static_cast<uint8_t>(m_ucFlags & ~flag);
+        }
+        void set_postresult(post_result result) {
+            m_ucFlags = static_cast<uint8_t>((m_ucFlags & ~flag_result) | (static_cast<uint8_t>(result) << 4));
+        }
     private:
         /// <summary>
-        /// Gibt die nchste eindeutige ID zurck.
+        /// Gibt die nächste eindeutige ID zurück.
         /// </summary>
-        /// <returns>Die nchste gltige ID vom Typ id_type.</returns>
+        /// <returns>Die nächste gültige ID vom Typ id_type.</returns>
         static id_type get_nextid(bool bIsIntern, bool bIsGroup = false) {
-            static uint32_t next_id =  0 ; // Starte bei 1, 0 = ungltig
+            static uint32_t next_id =  0 ; // Starte bei 1, 0 = ungültig
             
             id_type _ret =  id(next_id++);
 
@@ -319,15 +427,34 @@ namespace ses {
             return _ret;
         }
     protected:
-        uint8_t m_iCount;
+        // Nach Größe absteigend geordnet, damit zwischen den Feldern kein Verschnitt entsteht
+#ifdef SES_COMPACT_TIMESTAMP
+        int32_t m_iTimeStamp; // Zeitpunkt des Sendens in ms relativ zu time_base()
+#else
         uint64_t m_uiTimeStamp; // Zeitpunkt des Sendens
-        uint32_t m_uiAliveMs; // Gltigkeit
-        uint8_t  m_ucPriority; // 0 = hchste Prioritt
+#endif
+        uint32_t m_uiAliveMs; // Gültigkeit
 		id_type m_id; // ID des Messages
+        uint32_t m_uiTypeTag; // Typkennung für Batch-Verarbeitung
+        uint8_t  m_ucPriority; // 0 = höchste Priorität
+        uint8_t m_iCount;
         uint8_t m_iMaxCount;
-        bool m_bMarked;
+        uint8_t m_ucFlags; // flag_marked, flag_async, flag_pending, flag_forward, flag_result
     };
 
+    static_assert(sizeof(void*) != 8 || sizeof(message) <= 32, "message-Kopf ist größer als 32 Byte");
+
+    /// <summary>
+    /// Erzeugt eine Nachricht mit std::make_shared, sodass Nachricht und Kontrollblock des shared_ptr in einer Allokation liegen.
+    /// </summary>
+    /// <typeparam name="T">Der Nachrichtentyp.</typeparam>
+    /// <param name="args">Die Argumente für den Konstruktor von T.</param>
+    /// <returns>Der gemeinsam genutzte Zeiger auf die neue Nachricht.</returns>
+    template <class T, class... Args>
+    std::shared_ptr<T> make_message(Args&&... args) {
+        return std::make_shared<T>(std::forward<Args>(args)...);
+    }
+
     /// <summary>
     /// Die Klasse message_group verwaltet eine Gruppe von Nachrichtenobjekten und leitet Nachrichtenereignisse an alle gespeicherten Nachrichten weiter.
     /// </summary>
@@ -342,7 +469,7 @@ namespace ses {
         /// <summary>
         /// Konstruiert ein message_group-Objekt mit den angegebenen Parametern.
         /// </summary>
-        /// <param name="prio">Die Prioritt der Nachricht.</param>
+        /// <param name="prio">Die Priorität der Nachricht.</param>
         /// <param name="ms">Die gultikeit der nachricht (Standardwert ist 1000 ms).</param>
         /// <param name="bIsSystem">Gibt an, ob es sich um eine Systemnachricht handelt (Standardwert ist false).</param>
         message_group(uint8_t prio, uint32_t ms = 1000, bool bIsSystem = false) : message(prio, ms, bIsSystem, true) {   }
@@ -357,7 +484,7 @@ namespace ses {
         /// Wird aufgerufen, nachdem eine Nachricht gepostet wurde, und benachrichtigt alle gespeicherten Nachrichtenobjekte.
         /// </summary>
         /// <param name="sender">Ein Zeiger auf das Objekt, das die Nachricht gesendet hat.</param>
-        /// <param name="bWasAdd">Gibt an, ob die Nachricht hinzugefgt (true) oder entfernt (false) wurde.</param>
+        /// <param name="bWasAdd">Gibt an, ob die Nachricht hinzugefügt (true) oder entfernt (false) wurde.</param>
         virtual void onMessagePost(void* sender, bool bWasAdd) {
             for (auto& var : m_ptrMessages) {  
                 var->onMessagePost(sender, bWasAdd);  
@@ -367,7 +494,7 @@ namespace ses {
         /// Verarbeitet Nachrichten, indem sie an alle gespeicherten Nachrichtenobjekte weitergeleitet werden.
         /// </summary>
         /// <param name="sender">Ein Zeiger auf das Objekt, das die Nachricht sendet.</param>
-        /// <returns>Gibt true zurck, wenn die Verarbeitung erfolgreich war; andernfalls false.</returns>
+        /// <returns>Gibt true zurück, wenn die Verarbeitung erfolgreich war; andernfalls false.</returns>
         virtual bool onMessageProcess(void* sender) {
             for (auto& var : m_ptrMessages) {
                 var->onMessageProcess(sender);
@@ -375,9 +502,9 @@ namespace ses {
             return true;
         }
         /// <summary>
-        /// Wird aufgerufen, wenn eine Nachricht verworfen wird, und benachrichtigt alle gespeicherten Nachrichtenobjekte darber.
+        /// Wird aufgerufen, wenn eine Nachricht verworfen wird, und benachrichtigt alle gespeicherten Nachrichtenobjekte darüber.
         /// </summary>
-        /// <param name="sender">Ein Zeiger auf das Objekt, das das Ereignis ausgelst hat.</param>
+        /// <param name="sender">Ein Zeiger auf das Objekt, das das Ereignis ausgelöst hat.</param>
         /// <param name="time">Der Zeitstempel (in Mikrosekunden), zu dem die Nachricht verworfen wurde.</param>
         virtual void onMessageDiscard(void* sender, uint64_t time) {
             for (auto& var : m_ptrMessages) {
@@ -385,9 +512,9 @@ namespace ses {
             }
         }
         /// <summary>
-        /// Wird aufgerufen, wenn eine Nachricht abgelaufen ist, und benachrichtigt alle gespeicherten Nachrichtenobjekte darber.
+        /// Wird aufgerufen, wenn eine Nachricht abgelaufen ist, und benachrichtigt alle gespeicherten Nachrichtenobjekte darüber.
         /// </summary>
-        /// <param name="sender">Ein Zeiger auf das Objekt, das das Ereignis ausgelst hat.</param>
+        /// <param name="sender">Ein Zeiger auf das Objekt, das das Ereignis ausgelöst hat.</param>
         /// <param name="time">Der Zeitpunkt (als 64-Bit-Ganzzahl), zu dem die Nachricht abgelaufen ist.</param>
         virtual void onMessageExpired(void* sender, uint64_t time) {
             for (auto& var : m_ptrMessages) {
@@ -395,7 +522,7 @@ namespace ses {
             }
         }
         /// <summary>
-        /// Gibt die Anzahl der Nachrichten zurck.
+        /// Gibt die Anzahl der Nachrichten zurück.
         /// </summary>
         /// <returns>Die Anzahl der Nachrichten als size_t.</returns>
         size_t get_cound() {
@@ -403,7 +530,7 @@ namespace ses {
         }
 
         /// <summary>
-        /// Lscht alle Nachrichten aus der Sammlung.
+        /// Löscht alle Nachrichten aus der Sammlung.
         /// </summary>
         void clear() {
             m_ptrMessages.clear();
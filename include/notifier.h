@@ -0,0 +1,55 @@
+// SPDX-License-Identifier: EUPL-1.2
+
+#pragma once
+
+#include "config.h"
+
+namespace ses {
+
+#ifdef _WIN32
+    /// <summary>
+    /// HANDLE eines Events mit manuellem Zurücksetzen, für WaitForMultipleObjects oder Thread-Pool-Waits.
+    /// </summary>
+    using notify_handle = void*;
+#else
+    /// <summary>
+    /// Lesbarer Dateideskriptor für epoll, poll oder select: ein eventfd unter Linux, sonst das Leseende einer Pipe.
+    /// </summary>
+    using notify_handle = int;
+#endif
+
+    /// <summary>
+    /// Betriebssystem-Objekt, das signalisiert werden kann und bis zum Zurücksetzen lesbar bzw. gesetzt bleibt.
+    /// Mehrfaches Signalisieren ohne Zurücksetzen löst nur eine Benachrichtigung aus.
+    /// </summary>
+    class SES_API notifier {
+    public:
+        notifier();
+        ~notifier();
+
+        notifier(const notifier&) = delete;
+        notifier& operator=(const notifier&) = delete;
+
+        /// <summary>
+        /// Gibt an, ob das Betriebssystem-Objekt angelegt werden konnte.
+        /// </summary>
+        bool is_valid() const;
+        /// <summary>
+        /// Setzt das Objekt in den signalisierten Zustand.
+        /// </summary>
+        void signal();
+        /// <summary>
+        /// Setzt das Objekt zurück. Noch nicht gelesene Signale werden verworfen.
+        /// </summary>
+        void reset();
+        /// <summary>
+        /// Gibt das Handle zurück, auf das ein Reaktor warten kann. Es gehört dem notifier.
+        /// </summary>
+        notify_handle get_handle() const { return m_handle; }
+    private:
+        notify_handle m_handle;
+#if !defined(_WIN32) && !defined(__linux__)
+        int m_iWrite; // Schreibende der Pipe
+#endif
+    };
+}
@@ -0,0 +1,60 @@
+// SPDX-License-Identifier: EUPL-1.2
+
+#pragma once
+
+#include "config.h"
+#include <cstddef>
+#include <vector>
+
+namespace ses {
+
+    /// <summary>
+    /// Beschreibt die NUMA-Knoten eines Rechners und ihre logischen Prozessoren. Eine simulierte Topologie teilt die vorhandenen
+    /// Prozessoren auf eine beliebige Anzahl Knoten auf, damit sich NUMA-Verhalten auf Rechnern mit nur einem Knoten testen lässt.
+    /// </summary>
+    class SES_API numa_topology {
+    public:
+        /// <summary>
+        /// Ermittelt die Topologie des Rechners. Ist sie nicht bestimmbar, wird ein Knoten mit allen Prozessoren angenommen.
+        /// </summary>
+        static numa_topology detect();
+        /// <summary>
+        /// Erzeugt eine simulierte Topologie, die die vorhandenen Prozessoren zusammenhängend auf nodes Knoten verteilt.
+        /// </summary>
+        /// <param name="nodes">Die Anzahl simulierter Knoten (mindestens 1).</param>
+        static numa_topology simulated(size_t nodes);
+
+        /// <summary>
+        /// Gibt die Anzahl der Knoten zurück.
+        /// </summary>
+        size_t get_nodes() const { return m_vecCpus.size(); }
+        /// <summary>
+        /// Gibt die logischen Prozessoren eines Knotens zurück.
+        /// </summary>
+        const std::vector<unsigned>& get_cpus(size_t node) const { return m_vecCpus[node]; }
+        /// <summary>
+        /// Gibt an, ob die Topologie simuliert ist.
+        /// </summary>
+        bool is_simulated() const { return m_bSimulated; }
+
+        /// <summary>
+        /// Gibt den Knoten eines logischen Prozessors zurück (0, wenn er unbekannt ist).
+        /// </summary>
+        size_t node_of_cpu(unsigned cpu) const;
+        /// <summary>
+        /// Gibt den Knoten zurück, auf dem der aufrufende Thread gerade läuft.
+        /// </summary>
+        size_t current_node() const;
+
+        /// <summary>
+        /// Bindet den aufrufenden Thread an die Prozessoren eines Knotens.
+        /// </summary>
+        /// <returns>Gibt true zurück, wenn das Betriebssystem die Bindung übernommen hat, andernfalls false.</returns>
+        bool pin_thread(size_t node) const;
+    private:
+        numa_topology() : m_bSimulated(false) {}
+
+        std::vector<std::vector<unsigned>> m_vecCpus;
+        bool m_bSimulated;
+    };
+}
@@ -0,0 +1,87 @@
+// SPDX-License-Identifier: EUPL-1.2
+
+#pragma once
+
+#include "message.h"
+#include <algorithm>
+#include <vector>
+
+namespace ses {
+
+    /// <summary>
+    /// Kopfdaten einer wartenden Nachricht zum Zeitpunkt eines Schnappschusses.
+    /// </summary>
+    struct SES_API snapshot_entry {
+        uint32_t id;
+        uint32_t typetag;
+        uint64_t timestamp;
+        uint32_t alivems;
+        uint8_t  priority;
+        uint8_t  discards;
+        bool     marked;
+        bool     pending;
+    };
+
+    /// <summary>
+    /// Unveränderlicher Schnappschuss der wartenden Nachrichten eines eventmanager. Leser erhalten ihn ohne Sperre
+    /// über eventmanager::get_snapshot und können ihn beliebig lange auswerten, ohne die Verarbeitung zu blockieren.
+    /// </summary>
+    class SES_API queue_snapshot {
+    public:
+        queue_snapshot() : m_ulVersion(0), m_ulTime(0) {
+            std::fill(std::begin(m_aCount), std::end(m_aCount), 0);
+        }
+
+        /// <summary>
+        /// Gibt die fortlaufende Versionsnummer des Schnappschusses zurück.
+        /// </summary>
+        uint64_t get_version() const { return m_ulVersion; }
+        /// <summary>
+        /// Gibt den Zeitpunkt der Erstellung (tool::now) zurück.
+        /// </summary>
+        uint64_t get_time() const { return m_ulTime; }
+
+        /// <summary>
+        /// Gibt die Anzahl der Nachrichten im Schnappschuss zurück.
+        /// </summary>
+        size_t size() const { return m_vecEntries.size(); }
+        /// <summary>
+        /// Gibt alle Einträge in der Reihenfolge der Warteschlange zurück.
+        /// </summary>
+        const std::vector<snapshot_entry>& entries() const { return m_vecEntries; }
+
+        /// <summary>
+        /// Gibt die Anzahl der Nachrichten mit der angegebenen Priorität zurück.
+        /// </summary>
+        size_t count(uint8_t prio) const { return m_aCount[prio]; }
+        /// <summary>
+        /// Gibt die Anzahl der Nachrichten im Prioritätsbereich [from, to] zurück.
+        /// </summary>
+        size_t count(int from, int to) const {
+            size_t result = 0;
+            for (int prio = std::max(from, 0); prio <= std::min(to, 255); prio++)
+                result += m_aCount[prio];
+            return result;
+        }
+
+        /// <summary>
+        /// Sucht eine Nachricht anhand ihrer ID per binärer Suche.
+        /// </summary>
+        /// <param name="id">Die ID der Nachricht.</param>
+        /// <returns>Ein Zeiger auf den Eintrag oder nullptr, wenn die Nachricht nicht enthalten ist.</returns>
+        const snapshot_entry* find(message::id_type id) const {
+            auto it = std::lower_bound(m_vecById.begin(), m_vecById.end(), id.full,
+                [this](uint32_t index, uint32_t value) { return m_vecEntries[index].id < value; });
+            if (it == m_vecById.end() || m_vecEntries[*it].id != id.full) return nullptr;
+            return &m_vecEntries[*it];
+        }
+    private:
+        friend class eventmanager;
+
+        uint64_t m_ulVersion;
+        uint64_t m_ulTime;
+        std::vector<snapshot_entry> m_vecEntries;
+        std::vector<uint32_t> m_vecById; // Indizes in m_vecEntries, nach ID sortiert
+        size_t m_aCount[256];
+    };
+}
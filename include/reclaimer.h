@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: EUPL-1.2
+
+#pragma once
+
+#include "message.h"
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ses {
+
+    /// <summary>
+    /// Zerstört entfernte Nachrichten gesammelt außerhalb des kritischen Abschnitts des eventmanager.
+    /// Nachrichten werden blockweise übergeben und von einem eigenen Thread oder in Leerlaufzeiten über reclaim freigegeben.
+    /// Übersteigt der ausstehende Abfall die Obergrenze, gibt der übergebende Thread ihn selbst frei.
+    /// </summary>
+    class SES_API reclaimer {
+    public:
+        using message_ptr = std::shared_ptr<message>;
+
+        /// <summary>
+        /// Konstruiert einen reclaimer.
+        /// </summary>
+        /// <param name="maxGarbage">Die maximale Anzahl ausstehender Nachrichten (Standard: 4096).</param>
+        /// <param name="background">true, um einen eigenen Freigabe-Thread zu starten, false, um nur über reclaim freizugeben.</param>
+        reclaimer(size_t maxGarbage = 4096, bool background = true);
+        ~reclaimer();
+
+        reclaimer(const reclaimer&) = delete;
+        reclaimer& operator=(const reclaimer&) = delete;
+
+        /// <summary>
+        /// Übernimmt einen Block entfernter Nachrichten. Der Vektor ist danach leer.
+        /// </summary>
+        /// <param name="batch">Die entfernten Nachrichten.</param>
+        void retire(std::vector<message_ptr>& batch);
+        /// <summary>
+        /// Gibt allen ausstehenden Abfall im aufrufenden Thread frei, etwa in Leerlaufzeiten.
+        /// </summary>
+        /// <returns>Die Anzahl freigegebener Nachrichten.</returns>
+        size_t reclaim();
+
+        /// <summary>
+        /// Gibt die Anzahl noch nicht freigegebener Nachrichten zurück.
+        /// </summary>
+        size_t get_outstanding() const;
+    private:
+        void run();
+    private:
+        size_t m_ulMaxGarbage;
+        bool m_bStop;
+        mutable std::mutex m_mtxGarbage;
+        std::condition_variable m_cvGarbage;
+        std::vector<message_ptr> m_vecGarbage;
+        std::thread m_thread;
+    };
+}
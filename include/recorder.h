@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: EUPL-1.2
+
+#pragma once
+
+#include "message.h"
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ses {
+
+    /// <summary>
+    /// Art eines aufgezeichneten Ereignisses.
+    /// </summary>
+    enum class record_kind : uint8_t {
+        /// <summary>Die Nachricht wurde gepostet.</summary>
+        post = 0,
+        /// <summary>Ein Handler hat die Nachricht erfolgreich verarbeitet.</summary>
+        success,
+        /// <summary>Ein Handler hat false zurückgegeben, die Nachricht wird erneut versucht oder verworfen.</summary>
+        discard
+    };
+
+    /// <summary>
+    /// Satz der Aufzeichnungsdatei. Die Datei beginnt mit "SESR" und der Formatversion (uint32), danach folgen die Sätze.
+    /// </summary>
+    struct recorded_event {
+        uint64_t time;      // Mikrosekunden seit Beginn der Aufzeichnung
+        uint64_t id;        // message::id::full
+        uint32_t typetag;
+        uint32_t value;     // post: Lebensdauer in ms, success/discard: Dauer des Handlers in ns
+        record_kind kind;
+        uint8_t priority;
+        uint8_t reserved[6];
+    };
+    static_assert(sizeof(recorded_event) == 32, "recorded_event muss 32 Byte groß sein");
+
+    /// <summary>
+    /// Zeichnet den Nachrichtenstrom eines eventmanager in einer kompakten Binärdatei auf: Zeitpunkt, Priorität, Lebensdauer und Typ
+    /// jeder geposteten Nachricht sowie Ergebnis und Dauer jedes Handler-Aufrufs. Die Datei kann mit replayer erneut abgespielt werden.
+    /// </summary>
+    class SES_API recorder {
+    public:
+        recorder();
+        ~recorder();
+
+        recorder(const recorder&) = delete;
+        recorder& operator=(const recorder&) = delete;
+
+        /// <summary>
+        /// Öffnet die Aufzeichnungsdatei. Eine vorhandene Datei wird überschrieben, die Zeitmessung beginnt neu.
+        /// </summary>
+        /// <returns>Gibt true zurück, wenn die Datei geöffnet wurde, andernfalls false.</returns>
+        bool open(const std::string& path);
+        /// <summary>
+        /// Schreibt ausstehende Sätze und schließt die Datei.
+        /// </summary>
+        void close();
+        bool is_open() const;
+
+        /// <summary>
+        /// Zeichnet eine gepostete Nachricht auf.
+        /// </summary>
+        void recordPost(const message& msg);
+        /// <summary>
+        /// Zeichnet das Ergebnis eines Handler-Aufrufs auf.
+        /// </summary>
+        /// <param name="msg">Die verarbeitete Nachricht.</param>
+        /// <param name="success">Das Ergebnis des Handlers.</param>
+        /// <param name="costNs">Die Dauer des Aufrufs in Nanosekunden.</param>
+        void recordOutcome(const message& msg, bool success, uint64_t costNs);
+
+        /// <summary>
+        /// Gibt die Anzahl aufgezeichneter Sätze zurück.
+        /// </summary>
+        size_t get_records() const;
+
+        /// <summary>
+        /// Monotone Uhr in Nanosekunden, mit der Handler-Dauern gemessen werden.
+        /// </summary>
+        static uint64_t clock_ns();
+    private:
+        void append(const recorded_event& record);
+        void flush();
+    private:
+        mutable std::mutex m_mtxFile;
+        std::ofstream m_file;
+        std::vector<recorded_event> m_vecBuffer;
+        uint64_t m_ulStart;
+        size_t m_ulRecords;
+    };
+}
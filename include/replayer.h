@@ -0,0 +1,65 @@
+// SPDX-License-Identifier: EUPL-1.2
+
+#pragma once
+
+#include "eventmanager.h"
+#include "recorder.h"
+#include <string>
+#include <vector>
+
+namespace ses {
+
+    /// <summary>
+    /// Ergebnis eines Abspielvorgangs.
+    /// </summary>
+    struct replay_stats {
+        size_t posted;          // Gepostete Nachrichten
+        size_t rejected;        // Beim Posten abgelehnt (Kapazität, early drop, Timeout)
+        size_t processed;       // Erfolgreich verarbeitet
+        size_t discarded;       // Nach wiederholten Fehlschlägen oder Verdrängung verworfen
+        size_t expired;         // Vor der Verarbeitung abgelaufen
+        double seconds;         // Dauer vom ersten Posten bis zur letzten abgeschlossenen Nachricht
+        double throughput;      // Abgeschlossene Nachrichten pro Sekunde
+        double latency_avg_us;  // Mittlere Zeit vom Posten bis zum Abschluss
+        uint64_t latency_p50_us;
+        uint64_t latency_p99_us;
+        uint64_t latency_max_us;
+    };
+
+    /// <summary>
+    /// Spielt eine mit recorder erstellte Aufzeichnung gegen einen eventmanager ab. Ein Thread postet synthetische Nachrichten mit
+    /// aufgezeichneter Priorität, Lebensdauer und Typkennung im aufgezeichneten oder skalierten Takt, der aufrufende Thread verarbeitet sie.
+    /// Die synthetischen Handler verbrauchen die aufgezeichnete Dauer und liefern die aufgezeichneten Ergebnisse in derselben Reihenfolge.
+    /// </summary>
+    class SES_API replayer {
+    public:
+        /// <summary>
+        /// Liest eine Aufzeichnungsdatei.
+        /// </summary>
+        /// <returns>Gibt true zurück, wenn die Datei gültig ist, andernfalls false.</returns>
+        bool load(const std::string& path);
+
+        /// <summary>
+        /// Gibt die Anzahl aufgezeichneter Nachrichten zurück.
+        /// </summary>
+        size_t get_messages() const { return m_vecItems.size(); }
+
+        /// <summary>
+        /// Spielt die Aufzeichnung ab. Der eventmanager sollte leer sein, Handler und Einstellungen bleiben unverändert,
+        /// für die Typkennungen der Aufzeichnung dürfen aber keine Handler registriert sein.
+        /// </summary>
+        /// <param name="manager">Der eventmanager, der die Last erhält.</param>
+        /// <param name="speed">Faktor für den Takt der Aufzeichnung (2 = doppelt so schnell, 0 = ohne Pausen).</param>
+        /// <returns>Durchsatz und Latenzen des Durchlaufs.</returns>
+        replay_stats run(eventmanager& manager, double speed = 1.0) const;
+    private:
+        struct replay_item {
+            uint64_t time;
+            uint32_t typetag;
+            uint32_t alivems;
+            uint8_t priority;
+            std::vector<std::pair<bool, uint32_t>> outcomes; // Ergebnis und Dauer (ns) je Handler-Aufruf
+        };
+        std::vector<replay_item> m_vecItems;
+    };
+}
@@ -0,0 +1,93 @@
+// SPDX-License-Identifier: EUPL-1.2
+
+#pragma once
+
+#include "eventmanager.h"
+#include "numa_topology.h"
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace ses {
+
+    /// <summary>
+    /// Verteilt die Warteschlange auf einen eventmanager je NUMA-Knoten. Jeder Shard wird von einem an seinen Knoten gebundenen Thread
+    /// angelegt, Erzeuger posten in den Shard ihres Knotens und Worker verarbeiten bevorzugt ihren eigenen Shard. Fremde Shards werden
+    /// nur abgearbeitet, wenn der eigene im Prioritätsbereich leer ist oder dort eine um mehr als die Toleranz wichtigere Nachricht wartet.
+    /// </summary>
+    class SES_API sharded_eventmanager {
+    public:
+        using message_ptr = eventmanager::message_ptr;
+
+        /// <summary>
+        /// Konstruiert einen Shard je Knoten der Topologie.
+        /// </summary>
+        /// <param name="topology">Die (ggf. simulierte) Topologie.</param>
+        /// <param name="timedWaitMax">Die Lock-Wartezeit jedes Shards in Millisekunden.</param>
+        /// <param name="tolerance">Um wie viele Prioritätsstufen ein fremder Shard wichtiger sein muss, bevor ein Worker ihn dem eigenen vorzieht.</param>
+        sharded_eventmanager(const numa_topology& topology, uint64_t timedWaitMax, uint8_t tolerance = 0);
+
+        sharded_eventmanager(const sharded_eventmanager&) = delete;
+        sharded_eventmanager& operator=(const sharded_eventmanager&) = delete;
+
+        /// <summary>
+        /// Bindet den aufrufenden Thread an einen Knoten. Posten und Verarbeiten verwenden danach dessen Shard.
+        /// </summary>
+        /// <param name="node">Der Knoten.</param>
+        /// <returns>Gibt true zurück, wenn das Betriebssystem die Bindung übernommen hat. Der Knoten wird in jedem Fall gemerkt.</returns>
+        bool pin_worker(size_t node);
+        /// <summary>
+        /// Gibt den Knoten des aufrufenden Threads zurück: den mit pin_worker gesetzten oder den, auf dem er gerade läuft.
+        /// </summary>
+        size_t local_node() const;
+
+        /// <summary>
+        /// Postet eine Nachricht in den Shard des aufrufenden Threads.
+        /// </summary>
+        post_result postMessage(message_ptr msg, uint64_t maxWaitTime);
+        /// <summary>
+        /// Postet eine Nachricht in den Shard des angegebenen Knotens.
+        /// </summary>
+        post_result postMessage(size_t node, message_ptr msg, uint64_t maxWaitTime);
+        /// <summary>
+        /// Entfernt die Nachrichten aller Shards.
+        /// </summary>
+        void clearMessages();
+
+        /// <summary>
+        /// Führt einen Verarbeitungszyklus (begin, process, end) für den Prioritätsbereich [from, to] aus.
+        /// Gewählt wird der eigene Shard, außer er ist im Bereich leer oder ein fremder Shard hält eine um mehr als die Toleranz wichtigere Nachricht.
+        /// </summary>
+        /// <returns>Der verarbeitete Shard oder -1, wenn in keinem Shard eine Nachricht im Bereich wartet.</returns>
+        int processMessages(int from, int to);
+
+        /// <summary>
+        /// Ruft func für jeden Shard auf, etwa um Handler oder Kapazitäten überall zu registrieren.
+        /// </summary>
+        template <class TFunc>
+        void for_each_shard(TFunc func) {
+            for (auto& shard : m_vecShards) func(*shard);
+        }
+
+        size_t get_shards() const { return m_vecShards.size(); }
+        eventmanager& get_shard(size_t node) { return *m_vecShards[node]; }
+        const numa_topology& get_topology() const { return m_topology; }
+
+        /// <summary>
+        /// Gibt die Summe der wartenden Nachrichten aller Shards zurück.
+        /// </summary>
+        size_t get_messages() const;
+        /// <summary>
+        /// Gibt zurück, wie oft ein Worker einen fremden Shard verarbeitet hat.
+        /// </summary>
+        size_t get_steals() const { return m_ulSteals.load(); }
+
+        uint8_t get_tolerance() const { return m_ucTolerance; }
+        void set_tolerance(uint8_t tolerance) { m_ucTolerance = tolerance; }
+    private:
+        numa_topology m_topology;
+        std::vector<std::unique_ptr<eventmanager>> m_vecShards;
+        uint8_t m_ucTolerance;
+        std::atomic<size_t> m_ulSteals;
+    };
+}
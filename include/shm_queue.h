@@ -0,0 +1,106 @@
+// SPDX-License-Identifier: EUPL-1.2
+
+#pragma once
+
+#include "config.h"
+#include "tool.h"
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace ses {
+
+    struct shm_queue_header;
+    struct shm_queue_slot;
+
+    /// <summary>
+    /// Prioritätswarteschlange im gemeinsamen Speicher, die von mehreren Prozessen eines Rechners genutzt wird.
+    /// Nachrichten sind reine Daten fester Maximalgröße und liegen in Slots, die über Indizes statt Zeigern verkettet sind.
+    /// Jeder Prozess kann posten, Worker in anderen Prozessen verarbeiten ihren Prioritätsbereich direkt im gemeinsamen Speicher.
+    /// </summary>
+    class SES_API shm_queue {
+    public:
+        /// <summary>
+        /// Verarbeitet eine Nachricht ohne Kopie. Gibt true zurück, wenn die Nachricht verarbeitet wurde,
+        /// andernfalls wird sie verworfen und später erneut angeboten.
+        /// </summary>
+        using process_func = std::function<bool(uint8_t prio, uint32_t typeTag, const void* data, size_t size)>;
+
+        /// <summary>
+        /// Öffnet oder erzeugt die Warteschlange mit dem angegebenen Namen. Legen mehrere Prozesse gleichzeitig an, initialisiert nur
+        /// der erste, die übrigen öffnen den bestehenden Bereich. Passt dessen Größe nicht oder wird er nicht innerhalb einer Sekunde
+        /// initialisiert, gibt is_open false zurück.
+        /// </summary>
+        /// <param name="name">Der systemweite Name des Speicherbereichs (POSIX: beginnt mit '/').</param>
+        /// <param name="slotSize">Die maximale Größe der Nutzdaten einer Nachricht in Bytes.</param>
+        /// <param name="capacity">Die Anzahl der Slots.</param>
+        /// <param name="create">true, um den Bereich bei Bedarf anzulegen, false, um nur einen bestehenden zu öffnen.</param>
+        shm_queue(const std::string& name, size_t slotSize, size_t capacity, bool create);
+        ~shm_queue();
+
+        shm_queue(const shm_queue&) = delete;
+        shm_queue& operator=(const shm_queue&) = delete;
+
+        /// <summary>
+        /// Gibt an, ob der gemeinsame Speicher erfolgreich geöffnet wurde.
+        /// </summary>
+        bool is_open() const { return m_pBase != nullptr; }
+
+        /// <summary>
+        /// Kopiert die Nutzdaten in einen freien Slot und reiht die Nachricht ein.
+        /// </summary>
+        /// <returns>Gibt false zurück, wenn kein Slot frei ist oder die Nutzdaten zu groß sind.</returns>
+        bool postMessage(uint8_t prio, uint32_t typeTag, const void* data, size_t size, uint32_t aliveMs = 1000);
+
+        /// <summary>
+        /// Reserviert einen Slot, in den die Nutzdaten direkt geschrieben werden (ohne Kopie).
+        /// Die Nachricht wird erst mit commitMessage sichtbar.
+        /// </summary>
+        /// <param name="slot">Erhält den Index des reservierten Slots.</param>
+        /// <returns>Ein Zeiger auf den Nutzdatenbereich oder nullptr, wenn kein Slot frei ist.</returns>
+        void* reserveMessage(uint32_t& slot);
+        /// <summary>
+        /// Reiht eine mit reserveMessage vorbereitete Nachricht ein.
+        /// </summary>
+        /// <returns>Gibt false zurück, wenn der Slot nicht von diesem Prozess reserviert ist oder die Nutzdaten zu groß sind.</returns>
+        bool commitMessage(uint32_t slot, uint8_t prio, uint32_t typeTag, size_t size, uint32_t aliveMs = 1000);
+
+        /// <summary>
+        /// Verarbeitet wartende Nachrichten im Prioritätsbereich [from, to], höchste Priorität zuerst.
+        /// </summary>
+        /// <param name="maxCount">Die maximale Anzahl zu verarbeitender Nachrichten.</param>
+        /// <returns>Die Anzahl verarbeiteter Nachrichten.</returns>
+        size_t processMessages(int from, int to, process_func func, size_t maxCount = SIZE_MAX);
+
+        /// <summary>
+        /// Reiht Nachrichten wieder ein, deren verarbeitender Prozess beendet wurde, ohne sie abzuschließen.
+        /// </summary>
+        /// <returns>Die Anzahl wiederhergestellter Nachrichten.</returns>
+        size_t recoverMessages();
+
+        /// <summary>
+        /// Gibt die Anzahl wartender Nachrichten zurück.
+        /// </summary>
+        size_t get_messages() const;
+
+        /// <summary>
+        /// Entfernt den benannten Speicherbereich aus dem System. Geöffnete Abbildungen bleiben gültig.
+        /// </summary>
+        static void unlink(const std::string& name);
+    private:
+        shm_queue_slot* slot(uint32_t index) const;
+        shm_queue_header* header() const;
+        void unmap();
+        void lock();
+        void unlock();
+        void pushBack(uint32_t index);
+        void release(uint32_t index);
+        void rebuild();
+    private:
+        std::string m_strName;
+        uint8_t* m_pBase;
+        size_t m_ulMapSize;
+        void* m_pMapping;
+        uint32_t m_uiPid;
+    };
+}
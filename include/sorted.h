@@ -1,43 +1,56 @@
 /**
 * SES Smart Event System
-* (c) 2025 Amber-Sophia Schrck
+* (c) 2025 Amber-Sophia Schröck
 * This file is copyright under the latest version of the EUPL.
 * Please see LICENSE file for your rights under this license.
 **/
 #pragma once
 
+#include <cstdint>
 #include <functional>
 #include <iostream>
 
 namespace ses {
     /// <summary>
-    /// Abstrakte Basisklasse fr eine sortierte Containerstruktur mit optionaler automatischer Sortierung.
+    /// Abstrakte Basisklasse für eine sortierte Containerstruktur mit optionaler automatischer Sortierung.
     /// </summary>
     /// <typeparam name="T">Der Typ des zugrunde liegenden Containers.</typeparam>
     template<class T>
     class sorted {
     public:
         /// <summary>
-        /// Definiert einen Funktionsalias fr einen Vergleichsoperator zwischen zwei Objekten desselben Typs.
+        /// Definiert einen Funktionsalias für einen Vergleichsoperator zwischen zwei Objekten desselben Typs.
         /// </summary>
         using compare_func_t = std::function<bool(const T, const T)>;
+        /// <summary>
+        /// Definiert einen Funktionsalias für einen ganzzahligen Sortierschlüssel, dessen Reihenfolge der Vergleichsfunktion entspricht.
+        /// </summary>
+        using key_func_t = std::function<uint64_t(const T&)>;
 
         /// <summary>
         /// Konstruiert ein 'sorted'-Objekt mit der angegebenen automatischen Sortieroption.
         /// </summary>
         /// <param name="autoSorted">Legt fest, ob die automatische Sortierung aktiviert ist.</param>
-        explicit sorted(bool autoSorted ) : m_bAutosort(autoSorted), m_isSorted(false) {}
+        constexpr explicit sorted(bool autoSorted ) : m_bAutosort(autoSorted), m_isSorted(false) {}
 
         /// <summary>
-        /// Setzt die Vergleichsfunktion fr die Verarbeitung.
+        /// Setzt die Vergleichsfunktion für die Verarbeitung.
         /// </summary>
-        /// <param name="func">Die Funktionszeiger- oder Funktionsobjekt, das fr Vergleiche verwendet werden soll.</param>
+        /// <param name="func">Die Funktionszeiger- oder Funktionsobjekt, das für Vergleiche verwendet werden soll.</param>
         virtual void set_handle(compare_func_t func) = 0;
 
         /// <summary>
         /// Sortiert die Elemente in einer abgeleiteten Klasse.
         /// </summary>
         virtual void sort() = 0;
+
+        /// <summary>
+        /// Setzt einen Sortierschlüssel, mit dem Container ohne Vergleiche sortieren können. Wirksam ab dem nächsten sort bzw. set_handle.
+        /// Der Schlüssel muss dieselbe Ordnung ergeben wie die Vergleichsfunktion. Container ohne Schlüsselunterstützung ignorieren ihn.
+        /// </summary>
+        /// <param name="func">Die Schlüsselfunktion oder nullptr, um wieder nur die Vergleichsfunktion zu verwenden.</param>
+        /// <param name="keyBits">Die Anzahl genutzter Bits des Schlüssels.</param>
+        virtual void set_key(key_func_t /*func*/, unsigned /*keyBits*/ = 64) {}
      
 
 		/// <summary>
@@ -69,5 +82,22 @@ namespace ses {
         bool m_isSorted;
     };
 
+    /// <summary>
+    /// Halboffener Bereich [first, last) eines sortierten Containers, z. B. aus equal_range oder range. Kann direkt in einer
+    /// bereichsbasierten for-Schleife durchlaufen werden. Der Bereich wird ungültig, sobald der Container seine Iteratoren ungültig macht.
+    /// </summary>
+    /// <typeparam name="TIter">Der Iteratortyp des Containers.</typeparam>
+    template <class TIter>
+    struct sorted_range {
+        TIter first;
+        TIter last;
+
+        constexpr sorted_range(TIter f, TIter l) : first(f), last(l) {}
+
+        constexpr TIter begin() const { return first; }
+        constexpr TIter end() const { return last; }
+        constexpr bool empty() const { return first == last; }
+    };
+
 }
  
\ No newline at end of file
@@ -0,0 +1,233 @@
+// SPDX-License-Identifier: EUPL-1.2
+
+#pragma once
+#include <array>
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include "sorted.h"
+
+namespace ses {
+
+    /// <summary>
+    /// Ein sortiertes Array fester Größe, das vollständig constexpr ist und damit schon zur Übersetzungszeit sortiert werden kann,
+    /// etwa für statische Routing-Tabellen. Bis sorted_array::network_max Elemente wird mit einem verzweigungsfreien Sortiernetz
+    /// (Batcher Merge-Exchange) sortiert, darüber mit Heapsort. Die Sortierung ist nicht stabil.
+    /// </summary>
+    /// <typeparam name="T">Der Typ der Elemente.</typeparam>
+    /// <typeparam name="N">Die Anzahl der Elemente.</typeparam>
+    /// <typeparam name="TCompare">Der Vergleich, für constexpr-Nutzung mit constexpr operator() (Standard: std::less<T>).</typeparam>
+    template <typename T, std::size_t N, typename TCompare = std::less<T>>
+    class sorted_array : public sorted<T> {
+    public:
+        using base_type = sorted<T>;
+        using compare_func_t = typename base_type::compare_func_t;
+
+        using value_type = T;
+        using size_type = std::size_t;
+        using iterator = T*;
+        using const_iterator = const T*;
+
+        /// <summary>
+        /// Bis zu dieser Größe wird mit dem Sortiernetz sortiert.
+        /// </summary>
+        static constexpr size_type network_max = 32;
+
+        /// <summary>
+        /// Konstruiert ein sorted_array aus einem C-Array und sortiert es, wenn auto_sort gesetzt ist.
+        /// </summary>
+        /// <param name="data">Die Elemente.</param>
+        /// <param name="auto_sort">Legt fest, ob die Elemente sofort sortiert werden.</param>
+        /// <param name="comp">Der Vergleich.</param>
+        constexpr sorted_array(const T(&data)[N], bool auto_sort = true, TCompare comp = TCompare())
+            : base_type(auto_sort), m_aData{}, m_compare(comp) {
+            for (size_type i = 0; i < N; i++) m_aData[i] = data[i];
+            if (auto_sort) sortData();
+        }
+
+        /// <summary>
+        /// Konstruiert ein sorted_array aus einem std::array und sortiert es, wenn auto_sort gesetzt ist.
+        /// </summary>
+        /// <param name="data">Die Elemente.</param>
+        /// <param name="auto_sort">Legt fest, ob die Elemente sofort sortiert werden.</param>
+        /// <param name="comp">Der Vergleich.</param>
+        constexpr sorted_array(const std::array<T, N>& data, bool auto_sort = true, TCompare comp = TCompare())
+            : base_type(auto_sort), m_aData{}, m_compare(comp) {
+            for (size_type i = 0; i < N; i++) m_aData[i] = data[i];
+            if (auto_sort) sortData();
+        }
+
+        /// <summary>
+        /// Sortiert die Elemente mit TCompare.
+        /// </summary>
+        void sort() {
+            sortData();
+        }
+
+        /// <summary>
+        /// Sortiert die Elemente einmalig mit der angegebenen Funktion. Suchen verwenden weiterhin TCompare,
+        /// daher liefert is_sorted danach false.
+        /// </summary>
+        /// <param name="comp">Die Vergleichsfunktion.</param>
+        void set_handle(compare_func_t comp) {
+            std::sort(begin(), end(), comp);
+            base_type::m_isSorted = false;
+        }
+
+        /// <summary>
+        /// Gibt einen Zeiger auf das erste Element zurück, das nicht kleiner als key ist.
+        /// </summary>
+        template <typename K>
+        constexpr const_iterator lower_bound(const K& key) const {
+            size_type first = 0, count = N;
+            while (count > 0) {
+                size_type step = count / 2;
+                if (m_compare(m_aData[first + step], key)) {
+                    first += step + 1;
+                    count -= step + 1;
+                }
+                else count = step;
+            }
+            return m_aData + first;
+        }
+
+        /// <summary>
+        /// Gibt einen Zeiger auf das erste Element zurück, das größer als key ist.
+        /// </summary>
+        template <typename K>
+        constexpr const_iterator upper_bound(const K& key) const {
+            size_type first = 0, count = N;
+            while (count > 0) {
+                size_type step = count / 2;
+                if (!m_compare(key, m_aData[first + step])) {
+                    first += step + 1;
+                    count -= step + 1;
+                }
+                else count = step;
+            }
+            return m_aData + first;
+        }
+
+        /// <summary>
+        /// Gibt den Bereich der zu key gleichwertigen Elemente zurück.
+        /// </summary>
+        template <typename K>
+        constexpr std::pair<const_iterator, const_iterator> equal_range(const K& key) const {
+            return std::pair<const_iterator, const_iterator>(lower_bound(key), upper_bound(key));
+        }
+
+        /// <summary>
+        /// Gibt den Bereich aller Elemente zurück, die weder kleiner als low noch größer als high sind.
+        /// </summary>
+        template <typename K>
+        constexpr sorted_range<const_iterator> range(const K& low, const K& high) const {
+            return m_compare(high, low) ? sorted_range<const_iterator>(lower_bound(low), lower_bound(low))
+                                        : sorted_range<const_iterator>(lower_bound(low), upper_bound(high));
+        }
+
+        /// <summary>
+        /// Sucht ein zu key gleichwertiges Element.
+        /// </summary>
+        /// <returns>Ein Zeiger auf das Element oder end(), wenn keines vorhanden ist.</returns>
+        template <typename K>
+        constexpr const_iterator find(const K& key) const {
+            const_iterator it = lower_bound(key);
+            return (it != end() && !m_compare(key, *it)) ? it : end();
+        }
+
+        /// <summary>
+        /// Gibt an, ob ein zu key gleichwertiges Element vorhanden ist.
+        /// </summary>
+        template <typename K>
+        constexpr bool contains(const K& key) const {
+            return find(key) != end();
+        }
+
+        constexpr const T& operator[](size_type i) const { return m_aData[i]; }
+        constexpr T& operator[](size_type i) { return m_aData[i]; }
+
+        constexpr size_type size() const { return N; }
+        constexpr bool empty() const { return N == 0; }
+
+        constexpr iterator begin() { return m_aData; }
+        constexpr iterator end() { return m_aData + N; }
+        constexpr const_iterator begin() const { return m_aData; }
+        constexpr const_iterator end() const { return m_aData + N; }
+    private:
+        /// <summary>
+        /// Vergleicht und tauscht zwei Elemente ohne Verzweigung, damit der Übersetzer cmov- bzw. min/max-Befehle erzeugen kann.
+        /// </summary>
+        constexpr void compareExchange(size_type i, size_type j) {
+            T a = m_aData[i];
+            T b = m_aData[j];
+            bool swap = m_compare(b, a);
+            m_aData[i] = swap ? b : a;
+            m_aData[j] = swap ? a : b;
+        }
+
+        constexpr void sortNetwork() {
+            // Batcher Merge-Exchange (Knuth, TAOCP 5.2.2, Algorithmus M), für beliebiges N
+            size_type top = 1;
+            while (top < N) top <<= 1;
+            for (size_type p = top >> 1; p > 0; p >>= 1) {
+                size_type q = top >> 1, r = 0, d = p;
+                while (true) {
+                    for (size_type i = 0; i + d < N; i++) {
+                        if ((i & p) == r) compareExchange(i, i + d);
+                    }
+                    if (q == p) break;
+                    d = q - p;
+                    q >>= 1;
+                    r = p;
+                }
+            }
+        }
+
+        constexpr void siftDown(size_type root, size_type count) {
+            while (2 * root + 1 < count) {
+                size_type child = 2 * root + 1;
+                if (child + 1 < count && m_compare(m_aData[child], m_aData[child + 1])) child++;
+                if (!m_compare(m_aData[root], m_aData[child])) return;
+                T tmp = m_aData[root];
+                m_aData[root] = m_aData[child];
+                m_aData[child] = tmp;
+                root = child;
+            }
+        }
+
+        constexpr void sortHeap() {
+            for (size_type i = N / 2; i > 0; i--) siftDown(i - 1, N);
+            for (size_type last = N; last > 1; last--) {
+                T tmp = m_aData[0];
+                m_aData[0] = m_aData[last - 1];
+                m_aData[last - 1] = tmp;
+                siftDown(0, last - 1);
+            }
+        }
+
+        constexpr void sortData() {
+            if (N <= network_max) sortNetwork();
+            else sortHeap();
+            base_type::m_isSorted = true;
+        }
+    private:
+        T m_aData[(N > 0) ? N : 1];
+        TCompare m_compare;
+    };
+
+    template <typename T, std::size_t N, typename TCompare>
+    constexpr std::size_t sorted_array<T, N, TCompare>::network_max;
+
+    /// <summary>
+    /// Erzeugt ein sortiertes Array aus einer Initialisierungsliste, auch zur Übersetzungszeit.
+    /// </summary>
+    template <typename TCompare, typename T, std::size_t N>
+    constexpr sorted_array<T, N, TCompare> make_sorted_array(const T(&data)[N], TCompare comp = TCompare()) {
+        return sorted_array<T, N, TCompare>(data, true, comp);
+    }
+
+    template <typename T, std::size_t N>
+    constexpr sorted_array<T, N> make_sorted_array(const T(&data)[N]) {
+        return sorted_array<T, N>(data, true);
+    }
+}
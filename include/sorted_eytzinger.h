@@ -0,0 +1,419 @@
+// SPDX-License-Identifier: EUPL-1.2
+
+#pragma once
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+
+#include "sorted.h"
+#include "tool.h"
+
+namespace ses {
+    /// <summary>
+    /// Ein sortierter Container für große Mengen mit häufigen Suchen. Der Großteil der Elemente liegt in einem statischen, sortierten Bestand,
+    /// über den zusätzlich ein Suchbaum in Eytzinger-Anordnung (Breitensuche-Reihenfolge) mit Vorabladen gebaut wird. Eine Suche berührt so
+    /// je Ebene eine vorhersagbare Cache-Zeile statt zufälliger Positionen. Neue Elemente landen in einem kleinen sortierten Delta,
+    /// entfernte Elemente des Bestands werden nur markiert. Beides wird beim Überschreiten der Delta-Grenze in den Bestand eingemischt.
+    /// Der Container ist immer sortiert, gleichwertige Elemente bleiben in Einfügereihenfolge.
+    /// </summary>
+    /// <typeparam name="T">Der Typ der Elemente.</typeparam>
+    template <class T>
+    class sorted_eytzinger : public sorted<T> {
+    public:
+        using base_type = sorted<T>;
+        using compare_func_t = typename base_type::compare_func_t;
+        using key_func_t = typename base_type::key_func_t;
+
+        using value_type = T;
+        using reference = T&;
+        using const_reference = const T&;
+        using size_type = size_t;
+        using difference_type = std::ptrdiff_t;
+
+        /// <summary>
+        /// Vorwärts-Iterator, der Bestand und Delta in Sortierreihenfolge zusammenführt. Jede Änderung außer remove(iterator) macht ihn ungültig.
+        /// </summary>
+        template <bool TConst>
+        class basic_iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = typename std::conditional<TConst, const T*, T*>::type;
+            using reference = typename std::conditional<TConst, const T&, T&>::type;
+            using owner_type = typename std::conditional<TConst, const sorted_eytzinger, sorted_eytzinger>::type;
+
+            basic_iterator() : m_pOwner(nullptr), m_ulBase(0), m_ulDelta(0) {}
+            basic_iterator(owner_type* owner, size_t base, size_t delta) : m_pOwner(owner), m_ulBase(base), m_ulDelta(delta) {
+                m_ulBase = m_pOwner->skipRemoved(m_ulBase);
+            }
+            template <bool TOther, class = typename std::enable_if<TConst && !TOther>::type>
+            basic_iterator(const basic_iterator<TOther>& other) : m_pOwner(other.m_pOwner), m_ulBase(other.m_ulBase), m_ulDelta(other.m_ulDelta) {}
+
+            reference operator*() const {
+                return fromDelta() ? m_pOwner->m_vecDelta[m_ulDelta] : m_pOwner->m_vecBase[m_ulBase];
+            }
+            pointer operator->() const { return &**this; }
+
+            basic_iterator& operator++() {
+                if (fromDelta()) m_ulDelta++;
+                else m_ulBase = m_pOwner->skipRemoved(m_ulBase + 1);
+                return *this;
+            }
+            basic_iterator operator++(int) {
+                basic_iterator tmp(*this);
+                ++*this;
+                return tmp;
+            }
+
+            bool operator==(const basic_iterator& other) const { return m_ulBase == other.m_ulBase && m_ulDelta == other.m_ulDelta; }
+            bool operator!=(const basic_iterator& other) const { return !(*this == other); }
+        private:
+            friend class sorted_eytzinger;
+            template <bool> friend class basic_iterator;
+
+            // Bei Gleichwertigkeit kommt der ältere Bestand zuerst
+            bool fromDelta() const {
+                if (m_ulDelta >= m_pOwner->m_vecDelta.size()) return false;
+                if (m_ulBase >= m_pOwner->m_vecBase.size()) return true;
+                return m_pOwner->m_funcCompare(m_pOwner->m_vecDelta[m_ulDelta], m_pOwner->m_vecBase[m_ulBase]);
+            }
+
+            owner_type* m_pOwner;
+            size_t m_ulBase;
+            size_t m_ulDelta;
+        };
+
+        using iterator = basic_iterator<false>;
+        using const_iterator = basic_iterator<true>;
+
+        iterator        begin()         { return iterator(this, 0, 0); }
+        iterator        end()           { return iterator(this, m_vecBase.size(), m_vecDelta.size()); }
+        const_iterator  begin() const   { return const_iterator(this, 0, 0); }
+        const_iterator  end()   const   { return const_iterator(this, m_vecBase.size(), m_vecDelta.size()); }
+
+        /// <summary>
+        /// Konstruiert einen leeren Container. Er ist unabhängig von auto_sort immer sortiert.
+        /// </summary>
+        sorted_eytzinger(bool auto_sort = true)
+            : sorted_eytzinger(auto_sort, [](const T a, const T b) { return a < b; }) {
+        }
+
+        /// <summary>
+        /// Konstruiert einen leeren Container mit der angegebenen Vergleichsfunktion.
+        /// </summary>
+        sorted_eytzinger(bool auto_sort, compare_func_t func)
+            : base_type(auto_sort), m_funcCompare(func), m_ulRemoved(0), m_bNarrowKeys(false), m_ulDeltaLimit(0) {
+            base_type::m_isSorted = true;
+        }
+
+        /// <summary>
+        /// Setzt die Vergleichsfunktion und sortiert alle Elemente neu.
+        /// </summary>
+        void set_handle(compare_func_t comp) {
+            m_funcCompare = std::move(comp);
+            merge();
+            std::stable_sort(m_vecBase.begin(), m_vecBase.end(), m_funcCompare);
+            buildTree();
+        }
+
+        /// <summary>
+        /// Setzt einen Sortierschlüssel. Der Suchbaum enthält dann nur die Schlüssel, Suchen vergleichen Ganzzahlen statt Elemente.
+        /// Schlüssel bis 32 Bit werden schmal abgelegt, eine Cache-Zeile fasst dann doppelt so viele Baumplätze.
+        /// </summary>
+        void set_key(key_func_t func, unsigned keyBits = 64) {
+            m_funcKey = std::move(func);
+            m_bNarrowKeys = keyBits <= 32;
+            merge();
+            buildTree();
+        }
+
+        /// <summary>
+        /// Setzt, wie viele Elemente das Delta bzw. die Markierungen höchstens umfassen, bevor eingemischt wird (0 = Wurzel der Größe, mindestens 256).
+        /// </summary>
+        void set_delta_limit(size_t limit) {
+            m_ulDeltaLimit = limit;
+        }
+
+        /// <summary>
+        /// Mischt Delta und Markierungen in den Bestand ein und baut den Suchbaum neu.
+        /// </summary>
+        void sort() {
+            merge();
+        }
+
+        /// <summary>
+        /// Mischt Delta und Markierungen in den Bestand ein und baut den Suchbaum neu. Alle Iteratoren werden ungültig.
+        /// </summary>
+        void merge() {
+            if (!base_type::m_isSorted) {
+                std::stable_sort(m_vecDelta.begin(), m_vecDelta.end(), m_funcCompare);
+                base_type::m_isSorted = true;
+            }
+            if (m_vecDelta.empty() && m_ulRemoved == 0) return;
+
+            std::vector<T> merged;
+            merged.reserve(size());
+            auto delta = m_vecDelta.begin();
+            for (size_t index = 0; index < m_vecBase.size(); index++) {
+                if (m_vecRemoved[index]) continue;
+                while (delta != m_vecDelta.end() && m_funcCompare(*delta, m_vecBase[index]))
+                    merged.push_back(std::move(*delta++));
+                merged.push_back(std::move(m_vecBase[index]));
+            }
+            while (delta != m_vecDelta.end())
+                merged.push_back(std::move(*delta++));
+
+            m_vecBase.swap(merged);
+            m_vecDelta.clear();
+            buildTree();
+        }
+
+        void insert(const T& item) {
+            push_back(item);
+        }
+
+        /// <summary>
+        /// Fügt ein Element hinter allen gleichwertigen Elementen in das Delta ein. Bei Überschreiten der Grenze wird eingemischt.
+        /// Ohne Autosort wird nur angehängt und erst mit sort bzw. der nächsten Suche eingemischt (Massenladen).
+        /// </summary>
+        void push_back(const T& value) {
+            if (!base_type::m_bAutosort) {
+                m_vecDelta.push_back(value);
+                base_type::m_isSorted = false;
+                return;
+            }
+            ensureSorted();
+            m_vecDelta.insert(std::upper_bound(m_vecDelta.begin(), m_vecDelta.end(), value, m_funcCompare), value);
+            mergeIfNeeded();
+        }
+        void push_back(T&& value) {
+            if (!base_type::m_bAutosort) {
+                m_vecDelta.push_back(std::move(value));
+                base_type::m_isSorted = false;
+                return;
+            }
+            ensureSorted();
+            auto it = std::upper_bound(m_vecDelta.begin(), m_vecDelta.end(), value, m_funcCompare);
+            m_vecDelta.insert(it, std::move(value));
+            mergeIfNeeded();
+        }
+
+        /// <summary>
+        /// Gibt einen Iterator auf das erste Element zurück, das nicht kleiner als value ist.
+        /// </summary>
+        iterator lower_bound(const T& value) {
+            ensureSorted();
+            return iterator(this, baseBound(value, false),
+                std::lower_bound(m_vecDelta.begin(), m_vecDelta.end(), value, m_funcCompare) - m_vecDelta.begin());
+        }
+
+        /// <summary>
+        /// Gibt einen Iterator auf das erste Element zurück, das größer als value ist.
+        /// </summary>
+        iterator upper_bound(const T& value) {
+            ensureSorted();
+            return iterator(this, baseBound(value, true),
+                std::upper_bound(m_vecDelta.begin(), m_vecDelta.end(), value, m_funcCompare) - m_vecDelta.begin());
+        }
+
+        /// <summary>
+        /// Sucht das angegebene Element im Bereich gleichwertiger Elemente.
+        /// </summary>
+        /// <returns>Ein Iterator auf das Element oder end(), wenn es nicht vorhanden ist.</returns>
+        iterator find(const T& item) {
+            ensureSorted();
+            size_t deltaLower = std::lower_bound(m_vecDelta.begin(), m_vecDelta.end(), item, m_funcCompare) - m_vecDelta.begin();
+            for (size_t index = baseBound(item, false); index < m_vecBase.size() && !m_funcCompare(item, m_vecBase[index]); index++) {
+                if (!m_vecRemoved[index] && m_vecBase[index] == item)
+                    return iterator(this, index, deltaLower);
+            }
+            size_t baseUpper = baseBound(item, true);
+            for (size_t index = deltaLower; index < m_vecDelta.size() && !m_funcCompare(item, m_vecDelta[index]); index++) {
+                if (m_vecDelta[index] == item)
+                    return iterator(this, baseUpper, index);
+            }
+            return end();
+        }
+
+        /// <summary>
+        /// Gibt an, ob ein zu value gleichwertiges Element vorhanden ist.
+        /// </summary>
+        bool contains(const T& value) {
+            iterator it = lower_bound(value);
+            return it != end() && !m_funcCompare(value, *it);
+        }
+
+        /// <summary>
+        /// Entfernt das angegebene Element, falls es vorhanden ist.
+        /// </summary>
+        bool remove(const T& item) {
+            iterator it = find(item);
+            if (it == end()) return false;
+            remove(it);
+            return true;
+        }
+
+        /// <summary>
+        /// Entfernt das Element an der Position des Iterators. Elemente des Bestands werden nur markiert, es wird nicht eingemischt.
+        /// </summary>
+        /// <returns>Ein Iterator auf das nächste Element.</returns>
+        iterator remove(const iterator& item) {
+            if (item.fromDelta()) {
+                m_vecDelta.erase(m_vecDelta.begin() + item.m_ulDelta);
+                return iterator(this, item.m_ulBase, item.m_ulDelta);
+            }
+            m_vecRemoved[item.m_ulBase] = 1;
+            m_ulRemoved++;
+            return iterator(this, item.m_ulBase + 1, item.m_ulDelta);
+        }
+
+        void clear() {
+            m_vecBase.clear();
+            m_vecDelta.clear();
+            base_type::m_isSorted = true;
+            buildTree();
+        }
+
+        size_t size() const {
+            return m_vecBase.size() - m_ulRemoved + m_vecDelta.size();
+        }
+
+        bool empty() const {
+            return size() == 0;
+        }
+    private:
+        size_t skipRemoved(size_t index) const {
+            if (m_ulRemoved == 0) return index;
+            while (index < m_vecBase.size() && m_vecRemoved[index]) index++;
+            return index;
+        }
+
+        size_t deltaLimit() const {
+            if (m_ulDeltaLimit > 0) return m_ulDeltaLimit;
+            return std::max<size_t>(256, static_cast<size_t>(std::sqrt(static_cast<double>(m_vecBase.size()))));
+        }
+
+        void ensureSorted() {
+            if (!base_type::m_isSorted) merge();
+        }
+
+        void mergeIfNeeded() {
+            if (m_vecDelta.size() + m_ulRemoved > deltaLimit()) merge();
+        }
+
+        /// <summary>
+        /// Baut den Suchbaum in Eytzinger-Anordnung (Index 1 ist die Wurzel, Kinder von k liegen bei 2k und 2k+1).
+        /// </summary>
+        void buildTree() {
+            const size_t count = m_vecBase.size();
+            m_vecRemoved.assign(count, 0);
+            m_ulRemoved = 0;
+            m_vecTree.clear();
+            m_vecTreeKeys.clear();
+            m_vecTreeKeys32.clear();
+            if (!m_funcKey) m_vecTree.resize(count + 1);
+            else if (m_bNarrowKeys) m_vecTreeKeys32.resize(count + 1);
+            else m_vecTreeKeys.resize(count + 1);
+
+            fillTree(0, 1);
+        }
+
+        /// <summary>
+        /// Ordnet den sortierten Bestand per In-Order-Traversierung den Baumplätzen zu.
+        /// </summary>
+        size_t fillTree(size_t index, size_t k) {
+            if (k > m_vecBase.size()) return index;
+            index = fillTree(index, 2 * k);
+            if (!m_funcKey) m_vecTree[k] = m_vecBase[index];
+            else if (m_bNarrowKeys) m_vecTreeKeys32[k] = static_cast<uint32_t>(m_funcKey(m_vecBase[index]));
+            else m_vecTreeKeys[k] = m_funcKey(m_vecBase[index]);
+            return fillTree(index + 1, 2 * k + 1);
+        }
+
+        /// <summary>
+        /// Sucht im Eytzinger-Baum die erste Position im Bestand, die nicht kleiner (upper: größer) als value ist.
+        /// </summary>
+        size_t baseBound(const T& value, bool upper) const {
+            const size_t count = m_vecBase.size();
+            size_t k = 1;
+            if (m_funcKey) {
+                const uint64_t key = m_funcKey(value) + (upper ? 1 : 0);
+                if (upper && key == 0) return count;
+                if (!m_bNarrowKeys)
+                    k = descendKeys(m_vecTreeKeys.data(), count, key);
+                else if (key <= UINT32_MAX)
+                    k = descendKeys(m_vecTreeKeys32.data(), count, static_cast<uint32_t>(key));
+                else
+                    return count;
+                return (k == 0) ? count : rankOf(k, count);
+            }
+
+            const T* tree = m_vecTree.data();
+            while (k <= count) {
+                prefetchDescendants(tree, k);
+                k = 2 * k + (upper ? !m_funcCompare(value, tree[k]) : m_funcCompare(tree[k], value));
+            }
+            // Die zuletzt nach rechts verlassene Ebene liefert das Ergebnis
+            while (k & 1) k >>= 1;
+            k >>= 1;
+            return (k == 0) ? count : rankOf(k, count);
+        }
+
+        /// <summary>
+        /// Steigt verzweigungsfrei durch den Schlüsselbaum ab und gibt den Baumplatz des ersten Schlüssels zurück, der nicht kleiner
+        /// als key ist (0 = keiner).
+        /// </summary>
+        template <class TKey>
+        static size_t descendKeys(const TKey* tree, size_t count, TKey key) {
+            size_t k = 1;
+            while (k <= count) {
+                prefetchDescendants(tree, k);
+                k = 2 * k + (tree[k] < key);
+            }
+            while (k & 1) k >>= 1;
+            return k >> 1;
+        }
+
+        /// <summary>
+        /// Berechnet den Index im Bestand für den Baumplatz k ohne Speicherzugriff: den In-Order-Rang in einem vollständig gefüllten
+        /// Baum gleicher Höhe, abzüglich der in der untersten Ebene fehlenden Plätze, die davor liegen.
+        /// </summary>
+        static size_t rankOf(size_t k, size_t count) {
+            const unsigned height = tool::floor_log2(count);
+            const unsigned depth = tool::floor_log2(k);
+            const size_t perfect = ((2 * (k - (size_t(1) << depth)) + 1) << (height - depth)) - 1;
+            // Die Plätze der untersten Ebene haben im vollständigen Baum die geraden Ränge, vorhanden sind die ersten present
+            const size_t present = count - (size_t(1) << height) + 1;
+            const size_t lowest = (perfect + 1) / 2;
+            return (lowest > present) ? perfect - (lowest - present) : perfect;
+        }
+
+        /// <summary>
+        /// Lädt die 16 Nachfahren vier Ebenen unter k vor. Sie liegen zusammenhängend, bei 4-Byte-Schlüsseln in einer Cache-Zeile,
+        /// sodass die Speicherzugriffe von vier Ebenen gleichzeitig laufen statt nacheinander.
+        /// </summary>
+        template <class TEntry>
+        static void prefetchDescendants(const TEntry* tree, size_t k) {
+            const char* first = reinterpret_cast<const char*>(tree + 16 * k);
+            for (size_t offset = 0; offset < 16 * sizeof(TEntry); offset += 64)
+                tool::prefetch(first + offset);
+        }
+    private:
+        compare_func_t m_funcCompare;
+        key_func_t m_funcKey;
+        std::vector<T> m_vecBase;               // Sortierter Bestand
+        std::vector<uint8_t> m_vecRemoved;      // Markierungen entfernter Elemente des Bestands
+        size_t m_ulRemoved;
+        std::vector<T> m_vecTree;               // Eytzinger-Baum der Elemente, ohne Schlüssel
+        std::vector<uint64_t> m_vecTreeKeys;    // Eytzinger-Baum der Schlüssel, mit Schlüssel
+        std::vector<uint32_t> m_vecTreeKeys32;  // Eytzinger-Baum der Schlüssel bis 32 Bit
+        bool m_bNarrowKeys;
+        std::vector<T> m_vecDelta;              // Sortierte Neuzugänge
+        size_t m_ulDeltaLimit;
+    };
+}
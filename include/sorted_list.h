@@ -18,12 +18,12 @@ namespace ses {
         using const_iterator = typename container_type::const_iterator;
 
         sorted_list(bool auto_sort = true)
-            : sorted(auto_sort), m_funcCompare([](const T& a, const T& b) { return a < b; }), m_bIsSorted(auto_sort) {
+            : base_type(auto_sort), m_funcCompare([](const T& a, const T& b) { return a < b; }) {
         }
 
         void set_handle(compare_func_t comp) {
             m_funcCompare = std::move(comp);
-            if (autosort) {
+            if (base_type::m_bAutosort) {
                 sort();
             }
         }
@@ -33,34 +33,34 @@ namespace ses {
         }
 
         void push_back(const T& value) {
-            if (autosort) {
+            if (base_type::m_bAutosort) {
                 auto it = std::find_if(m_listData.begin(), m_listData.end(),
                     [&](const T& elem) { return m_funcCompare(value, elem); });
                 m_listData.insert(it, value);
-                m_bIsSorted = true;
+                base_type::m_isSorted = true;
             }
             else {
                 m_listData.push_back(value);
-                m_bIsSorted = false;
+                base_type::m_isSorted = false;
             }
         }
 
         void push_back(T&& value) {
-            if (autosort) {
+            if (base_type::m_bAutosort) {
                 auto it = std::find_if(m_listData.begin(), m_listData.end(),
                     [&](const T& elem) { return m_funcCompare(value, elem); });
                 m_listData.insert(it, std::move(value));
-                m_bIsSorted = true;
+                base_type::m_isSorted = true;
             }
             else {
                 m_listData.push_back(std::move(value));
-                m_bIsSorted = false;
+                base_type::m_isSorted = false;
             }
         }
 
         void sort() {
             m_listData.sort(m_funcCompare);
-            m_bIsSorted = true;
+            base_type::m_isSorted = true;
         }
 
         void clear() {
@@ -75,6 +75,38 @@ namespace ses {
             return m_listData.empty();
         }
 
+        iterator lower_bound(const T& value) {
+            if (!base_type::m_isSorted) sort();
+            return std::find_if(m_listData.begin(), m_listData.end(),
+                [&](const T& elem) { return !m_funcCompare(elem, value); });
+        }
+
+        iterator upper_bound(const T& value) {
+            if (!base_type::m_isSorted) sort();
+            return std::find_if(m_listData.begin(), m_listData.end(),
+                [&](const T& elem) { return m_funcCompare(value, elem); });
+        }
+
+        sorted_range<iterator> equal_range(const T& value) {
+            return range(value, value);
+        }
+
+        /// <summary>
+        /// Gibt den Bereich aller Elemente zurück, die weder vor low noch nach high einsortiert sind. Die Suche bleibt linear,
+        /// durchläuft aber nur die Elemente bis zum Ende des Bereichs.
+        /// </summary>
+        sorted_range<iterator> range(const T& low, const T& high) {
+            iterator first = lower_bound(low);
+            if (m_funcCompare(high, low)) return sorted_range<iterator>(first, first);
+            iterator last = std::find_if(first, m_listData.end(),
+                [&](const T& elem) { return m_funcCompare(high, elem); });
+            return sorted_range<iterator>(first, last);
+        }
+
+        iterator erase_range(const_iterator first, const_iterator last) {
+            return m_listData.erase(first, last);
+        }
+
         iterator begin() { return m_listData.begin(); }
         iterator end() { return m_listData.end(); }
         const_iterator begin() const { return m_listData.begin(); }
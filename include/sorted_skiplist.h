@@ -0,0 +1,498 @@
+// SPDX-License-Identifier: EUPL-1.2
+
+#pragma once
+#include <atomic>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "sorted.h"
+
+namespace ses {
+    /// <summary>
+    /// Eine nebenläufige Skip-Liste, die immer sortiert ist. Einfügen, Entfernen und Suchen sind in O(log n) aus beliebig vielen Threads
+    /// gleichzeitig erlaubt (feingranulare Sperren je Knoten, Lesen ohne Sperre). Gleichwertige Elemente bleiben in Einfügereihenfolge.
+    /// Entfernte Knoten werden erst in collect freigegeben, wenn weder eine Operation noch ein Iterator aktiv ist.
+    /// set_handle, sort und clear erfordern exklusiven Zugriff.
+    /// </summary>
+    /// <typeparam name="T">Der Typ der Elemente, die in der Skip-Liste gespeichert werden.</typeparam>
+    template <class T>
+    class sorted_skiplist : public sorted<T> {
+    public:
+        /// <summary>
+        /// Definiert einen Aliasnamen 'base_type' für den Typ 'sorted'.
+        /// </summary>
+        using base_type = sorted<T>;
+        /// <summary>
+        /// Definiert einen Alias für den Vergleichsfunktionstyp von base_type.
+        /// </summary>
+        using compare_func_t = typename base_type::compare_func_t;
+
+        using value_type = T;
+        using reference = T&;
+        using const_reference = const T&;
+        using size_type = size_t;
+        using difference_type = std::ptrdiff_t;
+
+        /// <summary>
+        /// Die maximale Anzahl Ebenen. Bei einer Wahrscheinlichkeit von 1/4 je Ebene reicht das für mehrere Milliarden Elemente.
+        /// </summary>
+        static const int max_level = 16;
+    private:
+        struct node {
+            T value;
+            int height;
+            std::atomic<bool> marked;  // logisch entfernt
+            std::atomic<bool> linked;  // auf allen Ebenen eingehängt
+            std::mutex mtx;
+            std::atomic<node*>* next;
+
+            template <class U>
+            node(U&& v, int h) : value(std::forward<U>(v)), height(h), marked(false), linked(false), next(new std::atomic<node*>[h]) {
+                for (int level = 0; level < h; level++) next[level].store(nullptr);
+            }
+            ~node() { delete[] next; }
+        };
+
+        struct active_guard {
+            std::atomic<int>& active;
+            explicit active_guard(std::atomic<int>& a) : active(a) { active.fetch_add(1); }
+            ~active_guard() { active.fetch_sub(1); }
+        };
+
+        static node* next_live(node* n) {
+            n = n->next[0].load();
+            while (n != nullptr && (n->marked.load() || !n->linked.load()))
+                n = n->next[0].load();
+            return n;
+        }
+    public:
+        /// <summary>
+        /// Vorwärts-Iterator über Ebene 0. Solange er auf ein Element zeigt, werden keine Knoten freigegeben.
+        /// </summary>
+        template <bool TConst>
+        class basic_iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = typename std::conditional<TConst, const T*, T*>::type;
+            using reference = typename std::conditional<TConst, const T&, T&>::type;
+
+            basic_iterator() : m_pNode(nullptr), m_pActive(nullptr) {}
+            basic_iterator(node* n, std::atomic<int>* active) : m_pNode(n), m_pActive((n != nullptr) ? active : nullptr) {
+                if (m_pActive != nullptr) m_pActive->fetch_add(1);
+            }
+            basic_iterator(const basic_iterator& other) : basic_iterator(other.m_pNode, other.m_pActive) {}
+            template <bool TOther, class = typename std::enable_if<TConst && !TOther>::type>
+            basic_iterator(const basic_iterator<TOther>& other) : basic_iterator(other.m_pNode, other.m_pActive) {}
+            ~basic_iterator() { unpin(); }
+
+            basic_iterator& operator=(const basic_iterator& other) {
+                if (this != &other) {
+                    if (other.m_pActive != nullptr) other.m_pActive->fetch_add(1);
+                    unpin();
+                    m_pNode = other.m_pNode;
+                    m_pActive = other.m_pActive;
+                }
+                return *this;
+            }
+
+            reference operator*() const { return m_pNode->value; }
+            pointer operator->() const { return &m_pNode->value; }
+
+            basic_iterator& operator++() {
+                m_pNode = next_live(m_pNode);
+                if (m_pNode == nullptr) unpin();
+                return *this;
+            }
+            basic_iterator operator++(int) {
+                basic_iterator tmp(*this);
+                ++*this;
+                return tmp;
+            }
+
+            bool operator==(const basic_iterator& other) const { return m_pNode == other.m_pNode; }
+            bool operator!=(const basic_iterator& other) const { return m_pNode != other.m_pNode; }
+        private:
+            friend class sorted_skiplist;
+            template <bool> friend class basic_iterator;
+
+            void unpin() {
+                if (m_pActive != nullptr) m_pActive->fetch_sub(1);
+                m_pActive = nullptr;
+            }
+
+            node* m_pNode;
+            std::atomic<int>* m_pActive;
+        };
+
+        using iterator = basic_iterator<false>;
+        using const_iterator = basic_iterator<true>;
+
+        iterator        begin()         { return iterator(next_live(m_pHead), &m_iActive); }
+        iterator        end()           { return iterator(); }
+        const_iterator  begin() const   { return const_iterator(next_live(m_pHead), &m_iActive); }
+        const_iterator  end()   const   { return const_iterator(); }
+
+        /// <summary>
+        /// Konstruiert eine leere Skip-Liste. Die Liste ist unabhängig von auto_sort immer sortiert.
+        /// </summary>
+        sorted_skiplist(bool auto_sort = true)
+            : sorted_skiplist(auto_sort, [](const T a, const T b) { return a < b; }) {
+        }
+
+        /// <summary>
+        /// Konstruiert eine leere Skip-Liste mit der angegebenen Vergleichsfunktion.
+        /// </summary>
+        sorted_skiplist(bool auto_sort, compare_func_t func)
+            : base_type(auto_sort), m_funcCompare(func), m_pHead(new node(T(), max_level)), m_ulSize(0), m_iActive(0) {
+            m_pHead->linked.store(true);
+            base_type::m_isSorted = true;
+        }
+
+        ~sorted_skiplist() {
+            clear();
+            delete m_pHead;
+        }
+
+        sorted_skiplist(const sorted_skiplist&) = delete;
+        sorted_skiplist& operator=(const sorted_skiplist&) = delete;
+
+        /// <summary>
+        /// Setzt die Vergleichsfunktion und baut die Liste in der neuen Ordnung auf. Erfordert exklusiven Zugriff.
+        /// </summary>
+        void set_handle(compare_func_t comp) {
+            std::vector<T> values;
+            values.reserve(size());
+            for (auto& value : *this) values.push_back(std::move(value));
+            clear();
+            m_funcCompare = std::move(comp);
+            for (auto& value : values) push_back(std::move(value));
+        }
+
+        /// <summary>
+        /// Die Skip-Liste ist immer sortiert, es ist nichts zu tun.
+        /// </summary>
+        void sort() {
+            base_type::m_isSorted = true;
+        }
+
+        /// <summary>
+        /// Fügt ein Element hinter allen gleichwertigen Elementen ein.
+        /// </summary>
+        void insert(const T& item) {
+            push_back(item);
+        }
+        void push_back(const T& value) {
+            insertNode(new node(value, random_level()));
+        }
+        void push_back(T&& value) {
+            insertNode(new node(std::move(value), random_level()));
+        }
+
+        /// <summary>
+        /// Sucht das angegebene Element im Bereich gleichwertiger Elemente.
+        /// </summary>
+        /// <returns>Ein Iterator auf das Element oder end(), wenn es nicht vorhanden ist.</returns>
+        iterator find(const T& item) {
+            active_guard guard(m_iActive);
+            node* pred = m_pHead;
+            node* curr = nullptr;
+            for (int level = max_level - 1; level >= 0; level--) {
+                curr = pred->next[level].load();
+                while (curr != nullptr && m_funcCompare(curr->value, item)) {
+                    pred = curr;
+                    curr = pred->next[level].load();
+                }
+            }
+            for (; curr != nullptr && !m_funcCompare(item, curr->value); curr = curr->next[0].load()) {
+                if (!curr->marked.load() && curr->linked.load() && curr->value == item)
+                    return iterator(curr, &m_iActive);
+            }
+            return end();
+        }
+
+        /// <summary>
+        /// Gibt die Position des ersten Elements zurück, das nicht vor value einsortiert ist.
+        /// </summary>
+        iterator lower_bound(const T& value) {
+            active_guard guard(m_iActive);
+            node* pred = m_pHead;
+            for (int level = max_level - 1; level >= 0; level--) {
+                node* curr = pred->next[level].load();
+                while (curr != nullptr && m_funcCompare(curr->value, value)) {
+                    pred = curr;
+                    curr = pred->next[level].load();
+                }
+            }
+            return iterator(next_live(pred), &m_iActive);
+        }
+
+        /// <summary>
+        /// Gibt die Position des ersten Elements zurück, das nach value einsortiert ist.
+        /// </summary>
+        iterator upper_bound(const T& value) {
+            active_guard guard(m_iActive);
+            node* pred = m_pHead;
+            for (int level = max_level - 1; level >= 0; level--) {
+                node* curr = pred->next[level].load();
+                while (curr != nullptr && !m_funcCompare(value, curr->value)) {
+                    pred = curr;
+                    curr = pred->next[level].load();
+                }
+            }
+            return iterator(next_live(pred), &m_iActive);
+        }
+
+        /// <summary>
+        /// Gibt den Bereich der zu value gleichwertigen Elemente zurück.
+        /// </summary>
+        sorted_range<iterator> equal_range(const T& value) {
+            return range(value, value);
+        }
+
+        /// <summary>
+        /// Gibt den Bereich aller Elemente zurück, die weder vor low noch nach high einsortiert sind, in erwartet O(log n).
+        /// Gleichzeitig eingefügte Elemente können im Bereich erscheinen oder fehlen.
+        /// </summary>
+        sorted_range<iterator> range(const T& low, const T& high) {
+            if (m_funcCompare(high, low)) return sorted_range<iterator>(end(), end());
+            return sorted_range<iterator>(lower_bound(low), upper_bound(high));
+        }
+
+        /// <summary>
+        /// Entfernt alle Elemente im Bereich [first, last).
+        /// </summary>
+        /// <returns>Ein Iterator auf das Element nach dem entfernten Bereich.</returns>
+        iterator erase_range(iterator first, const iterator& last) {
+            while (first != last) first = remove(first);
+            return first;
+        }
+
+        /// <summary>
+        /// Entfernt alle Elemente, für die pred true liefert. pred wird für jedes Element genau einmal in Sortierreihenfolge aufgerufen.
+        /// </summary>
+        /// <returns>Die Anzahl entfernter Elemente.</returns>
+        template <class TPredicate>
+        size_t remove_if(TPredicate pred) {
+            size_t count = 0;
+            for (iterator it = begin(); it != end(); ) {
+                if (pred(*it)) {
+                    it = remove(it);
+                    count++;
+                }
+                else
+                    ++it;
+            }
+            return count;
+        }
+
+        /// <summary>
+        /// Entfernt das angegebene Element, falls es vorhanden ist.
+        /// </summary>
+        /// <returns>Gibt true zurück, wenn das Element entfernt wurde, andernfalls false.</returns>
+        bool remove(const T& item) {
+            iterator it = find(item);
+            if (it == end()) return false;
+            active_guard guard(m_iActive);
+            return removeNode(it.m_pNode);
+        }
+
+        /// <summary>
+        /// Entfernt das Element an der Position des Iterators.
+        /// </summary>
+        /// <returns>Ein Iterator auf das nächste Element.</returns>
+        iterator remove(const iterator& item) {
+            active_guard guard(m_iActive);
+            removeNode(item.m_pNode);
+            return iterator(next_live(item.m_pNode), &m_iActive);
+        }
+
+        /// <summary>
+        /// Gibt entfernte Knoten frei, sofern gerade weder eine Operation noch ein Iterator aktiv ist.
+        /// </summary>
+        /// <returns>Die Anzahl freigegebener Knoten.</returns>
+        size_t collect() {
+            std::vector<node*> retired;
+            {
+                const std::lock_guard<std::mutex> lock(m_mtxRetired);
+                retired.swap(m_vecRetired);
+            }
+            if (retired.empty()) return 0;
+            // Die Knoten sind bereits ausgehängt, neue Zugriffe erreichen sie nicht mehr
+            if (m_iActive.load() != 0) {
+                const std::lock_guard<std::mutex> lock(m_mtxRetired);
+                m_vecRetired.insert(m_vecRetired.end(), retired.begin(), retired.end());
+                return 0;
+            }
+            for (node* n : retired) delete n;
+            return retired.size();
+        }
+
+        /// <summary>
+        /// Löscht alle Elemente. Erfordert exklusiven Zugriff.
+        /// </summary>
+        void clear() {
+            node* n = m_pHead->next[0].load();
+            while (n != nullptr) {
+                node* next = n->next[0].load();
+                delete n;
+                n = next;
+            }
+            for (int level = 0; level < max_level; level++)
+                m_pHead->next[level].store(nullptr);
+            {
+                const std::lock_guard<std::mutex> lock(m_mtxRetired);
+                for (node* r : m_vecRetired) delete r;
+                m_vecRetired.clear();
+            }
+            m_ulSize.store(0);
+        }
+
+        /// <summary>
+        /// Gibt die Anzahl der Elemente zurück.
+        /// </summary>
+        size_t size() const {
+            return m_ulSize.load();
+        }
+
+        /// <summary>
+        /// Prüft, ob die Skip-Liste leer ist.
+        /// </summary>
+        bool empty() const {
+            return m_ulSize.load() == 0;
+        }
+    private:
+        static int random_level() {
+            static thread_local uint64_t state = reinterpret_cast<uintptr_t>(&state) | 1;
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            uint64_t bits = state;
+            int height = 1;
+            while (height < max_level && (bits & 3) == 0) {
+                height++;
+                bits >>= 2;
+            }
+            return height;
+        }
+
+        static void unlockPreds(node** preds, int highest) {
+            for (int level = 0; level <= highest; level++) {
+                if (level == 0 || preds[level] != preds[level - 1])
+                    preds[level]->mtx.unlock();
+            }
+        }
+
+        void insertNode(node* n) {
+            active_guard guard(m_iActive);
+            node* preds[max_level];
+            node* succs[max_level];
+
+            while (true) {
+                // Vorgänger hinter allen gleichwertigen Elementen suchen
+                node* pred = m_pHead;
+                for (int level = max_level - 1; level >= 0; level--) {
+                    node* curr = pred->next[level].load();
+                    while (curr != nullptr && !m_funcCompare(n->value, curr->value)) {
+                        pred = curr;
+                        curr = pred->next[level].load();
+                    }
+                    preds[level] = pred;
+                    succs[level] = curr;
+                }
+
+                // Vorgänger von unten nach oben sperren und prüfen
+                bool valid = true;
+                int highest = -1;
+                for (int level = 0; valid && level < n->height; level++) {
+                    if (level == 0 || preds[level] != preds[level - 1])
+                        preds[level]->mtx.lock();
+                    highest = level;
+                    valid = !preds[level]->marked.load() && (succs[level] == nullptr || !succs[level]->marked.load())
+                        && preds[level]->next[level].load() == succs[level];
+                }
+                if (!valid) {
+                    unlockPreds(preds, highest);
+                    continue;
+                }
+
+                for (int level = 0; level < n->height; level++)
+                    n->next[level].store(succs[level]);
+                for (int level = 0; level < n->height; level++)
+                    preds[level]->next[level].store(n);
+                n->linked.store(true);
+                unlockPreds(preds, highest);
+                break;
+            }
+            m_ulSize.fetch_add(1);
+        }
+
+        bool removeNode(node* victim) {
+            while (!victim->linked.load())
+                std::this_thread::yield();
+            {
+                // Nach dem Markieren scheitert jedes Einfügen hinter dem Knoten an der Prüfung, seine Nachfolger bleiben stabil
+                const std::lock_guard<std::mutex> lock(victim->mtx);
+                if (victim->marked.load()) return false;
+                victim->marked.store(true);
+            }
+
+            node* preds[max_level];
+            while (true) {
+                // Auf jeder Ebene den direkten Vorgänger des Knotens suchen
+                node* pred = m_pHead;
+                for (int level = max_level - 1; level >= 0; level--) {
+                    node* curr = pred->next[level].load();
+                    while (curr != nullptr && m_funcCompare(curr->value, victim->value)) {
+                        pred = curr;
+                        curr = pred->next[level].load();
+                    }
+                    if (level < victim->height) {
+                        while (curr != nullptr && curr != victim) {
+                            pred = curr;
+                            curr = pred->next[level].load();
+                        }
+                        preds[level] = pred;
+                    }
+                }
+
+                bool valid = true;
+                int highest = -1;
+                for (int level = 0; valid && level < victim->height; level++) {
+                    if (level == 0 || preds[level] != preds[level - 1])
+                        preds[level]->mtx.lock();
+                    highest = level;
+                    valid = !preds[level]->marked.load() && preds[level]->next[level].load() == victim;
+                }
+                if (!valid) {
+                    unlockPreds(preds, highest);
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                for (int level = victim->height - 1; level >= 0; level--)
+                    preds[level]->next[level].store(victim->next[level].load());
+                unlockPreds(preds, highest);
+                break;
+            }
+            m_ulSize.fetch_sub(1);
+            {
+                const std::lock_guard<std::mutex> lock(m_mtxRetired);
+                m_vecRetired.push_back(victim);
+            }
+            return true;
+        }
+    private:
+        compare_func_t m_funcCompare;
+        node* m_pHead;
+        std::atomic<size_t> m_ulSize;
+        mutable std::atomic<int> m_iActive;
+        std::mutex m_mtxRetired;
+        std::vector<node*> m_vecRetired;
+    };
+}
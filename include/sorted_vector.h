@@ -4,6 +4,7 @@
 #include <vector>
 #include <functional>
 #include <algorithm>
+#include <cstdint>
 
 #include "sorted.h"
 
@@ -12,30 +13,34 @@ namespace ses {
     /// Eine generische Container-Klasse, die einen sortierten Vektor mit optionaler automatischer Sortierung und benutzerdefinierbarer Vergleichsfunktion implementiert.
     /// </summary>
     /// <typeparam name="T">Der Typ der Elemente, die im sortierten Vektor gespeichert werden.</typeparam>
-    /// <typeparam name="TAlloc">Der Typ des Allocators, der fr die Speicherverwaltung verwendet wird (Standard: std::allocator<T>).</typeparam>
+    /// <typeparam name="TAlloc">Der Typ des Allocators, der für die Speicherverwaltung verwendet wird (Standard: std::allocator<T>).</typeparam>
     template <class T>
     class sorted_vector : public sorted<T> {
     public:
         /// <summary>
-        /// Definiert einen Aliasnamen 'base_type' fr den Typ 'sorted'.
+        /// Definiert einen Aliasnamen 'base_type' für den Typ 'sorted'.
         /// </summary>
         using base_type = sorted<T>;
         /// <summary>
-        /// Definiert einen Alias fr den Vergleichsfunktionstyp von base_type.
+        /// Definiert einen Alias für den Vergleichsfunktionstyp von base_type.
         /// </summary>
         using compare_func_t = typename base_type::compare_func_t;
+        /// <summary>
+        /// Definiert einen Alias für den Schlüsselfunktionstyp von base_type.
+        /// </summary>
+        using key_func_t = typename base_type::key_func_t;
 
         /// <summary>
-        /// Definiert einen Alias fr einen std::vector mit dem angegebenen Element- und Allocator-Typ.
+        /// Definiert einen Alias für einen std::vector mit dem angegebenen Element- und Allocator-Typ.
         /// </summary>
         using container_type = std::vector<T>;
 
         /// <summary>
-        /// Definiert einen Alias fr den Iterator-Typ eines std::vector mit Elementtyp T.
+        /// Definiert einen Alias für den Iterator-Typ eines std::vector mit Elementtyp T.
         /// </summary>
         using iterator = typename container_type::iterator;
         /// <summary>
-        /// Definiert einen Typalias fr den konstanten Iterator eines std::vector mit Elementen vom Typ T.
+        /// Definiert einen Typalias für den konstanten Iterator eines std::vector mit Elementen vom Typ T.
         /// </summary>
         using const_iterator = typename container_type::const_iterator;
 
@@ -55,17 +60,17 @@ namespace ses {
         /// <summary>
         /// Konstruiert ein sorted_vector-Objekt mit optionaler automatischer Sortierung.
         /// </summary>
-        /// <param name="auto_sort">Legt fest, ob das sortierte Verhalten beim Einfgen von Elementen automatisch aktiviert wird. Standardmig auf true gesetzt.</param>
+        /// <param name="auto_sort">Legt fest, ob das sortierte Verhalten beim Einfügen von Elementen automatisch aktiviert wird. Standardmäßig auf true gesetzt.</param>
         sorted_vector(bool auto_sort = true)
-            : base_type(auto_sort), m_funcCompare([](const T a, const T b) { return a < b; }) {
+            : base_type(auto_sort), m_funcCompare([](const T a, const T b) { return a < b; }), m_uiKeyBits(64), m_bBuckets(false) {
         }
 
         /// <summary>
         /// Konstruiert ein sorted_vector-Objekt mit optionaler automatischer Sortierung.
         /// </summary>
-        /// <param name="auto_sort">Legt fest, ob das sortierte Verhalten beim Einfgen von Elementen automatisch aktiviert wird. Standardmig auf true gesetzt.</param>
+        /// <param name="auto_sort">Legt fest, ob das sortierte Verhalten beim Einfügen von Elementen automatisch aktiviert wird. Standardmäßig auf true gesetzt.</param>
         sorted_vector(bool auto_sort, compare_func_t func)
-            : base_type(auto_sort), m_funcCompare(func) {
+            : base_type(auto_sort), m_funcCompare(func), m_uiKeyBits(64), m_bBuckets(false) {
         }
 
         /// <summary>
@@ -75,14 +80,26 @@ namespace ses {
         void set_handle(compare_func_t comp) {
             m_funcCompare = std::move(comp);
             if (base_type::m_bAutosort) {
-                std::sort(m_vecData.begin(), m_vecData.end(), m_funcCompare);
+                sort();
             }
         }
 
         /// <summary>
-        /// Fgt ein Element am Ende der Sammlung hinzu.
+        /// Setzt einen Sortierschlüssel. sort und set_handle sortieren dann per Radixsort in linearer Zeit statt per Vergleich.
+        /// Bei Schlüsseln bis 8 Bit werden zusätzlich die Grenzen jedes Schlüsselwerts gehalten, sodass Einfügen und Suchen ohne binäre Suche auskommen.
+        /// </summary>
+        /// <param name="func">Die Schlüsselfunktion oder nullptr.</param>
+        /// <param name="keyBits">Die Anzahl genutzter Bits des Schlüssels (1 bis 64).</param>
+        void set_key(key_func_t func, unsigned keyBits = 64) {
+            m_funcKey = std::move(func);
+            m_uiKeyBits = std::min(std::max(keyBits, 1u), 64u);
+            m_bBuckets = false;
+        }
+
+        /// <summary>
+        /// Fügt ein Element am Ende der Sammlung hinzu.
         /// </summary>
-        /// <param name="item">Das einzufgende Element.</param>
+        /// <param name="item">Das einzufügende Element.</param>
         void insert(const T& item) {
             push_back(item); 
 		}
@@ -91,73 +108,183 @@ namespace ses {
         /// Entfernt das angegebene Element aus der Sammlung, falls es vorhanden ist.
         /// </summary>
         /// <param name="item">Das zu entfernende Element.</param>
-        /// <returns>Gibt true zurck, wenn das Element entfernt wurde, andernfalls false.</returns>
+        /// <returns>Gibt true zurück, wenn das Element entfernt wurde, andernfalls false.</returns>
         bool remove(const T& item) {
             bool _ret = false;
-            auto it = std::find(m_vecData.begin(), m_vecData.end(), item);
+            auto it = find(item);
             if (it != m_vecData.end()) {
-                m_vecData.erase(it);
+                remove(it);
                 _ret = true;
             }
             return _ret;
         }
 
+        /// <summary>
+        /// Sucht das angegebene Element. Ist der Vektor sortiert, wird nur der Bereich gleichwertiger Elemente durchsucht.
+        /// </summary>
+        /// <param name="item">Das gesuchte Element.</param>
+        /// <returns>Ein Iterator auf das Element oder end(), wenn es nicht vorhanden ist.</returns>
+        iterator find(const T& item) {
+            if (!base_type::m_isSorted) {
+                return std::find(m_vecData.begin(), m_vecData.end(), item);
+            }
+            if (m_bBuckets) {
+                size_t key = bucketOf(item);
+                auto last = m_vecData.begin() + m_vecBucketEnd[key];
+                auto it = std::find(m_vecData.begin() + bucketBegin(key), last, item);
+                return (it != last) ? it : m_vecData.end();
+            }
+            auto range = std::equal_range(m_vecData.begin(), m_vecData.end(), item, m_funcCompare);
+            auto it = std::find(range.first, range.second, item);
+            return (it != range.second) ? it : m_vecData.end();
+        }
+
+        /// <summary>
+        /// Gibt die Position des ersten Elements zurück, das nicht vor value einsortiert ist. Ein unsortierter Vektor wird zuvor sortiert.
+        /// </summary>
+        iterator lower_bound(const T& value) {
+            if (!base_type::m_isSorted) sort();
+            if (m_bBuckets) return m_vecData.begin() + bucketBegin(bucketOf(value));
+            return std::lower_bound(m_vecData.begin(), m_vecData.end(), value, m_funcCompare);
+        }
+
+        /// <summary>
+        /// Gibt die Position des ersten Elements zurück, das nach value einsortiert ist. Ein unsortierter Vektor wird zuvor sortiert.
+        /// </summary>
+        iterator upper_bound(const T& value) {
+            if (!base_type::m_isSorted) sort();
+            if (m_bBuckets) return m_vecData.begin() + m_vecBucketEnd[bucketOf(value)];
+            return std::upper_bound(m_vecData.begin(), m_vecData.end(), value, m_funcCompare);
+        }
+
+        /// <summary>
+        /// Gibt den Bereich der zu value gleichwertigen Elemente zurück.
+        /// </summary>
+        sorted_range<iterator> equal_range(const T& value) {
+            return range(value, value);
+        }
+
+        /// <summary>
+        /// Gibt den Bereich aller Elemente zurück, die weder vor low noch nach high einsortiert sind, in O(log n) bzw. mit Schlüssel in O(1).
+        /// </summary>
+        /// <param name="low">Das Element, dessen gleichwertige Elemente den Bereich eröffnen.</param>
+        /// <param name="high">Das Element, dessen gleichwertige Elemente den Bereich abschließen.</param>
+        sorted_range<iterator> range(const T& low, const T& high) {
+            iterator first = lower_bound(low);
+            iterator last = upper_bound(high);
+            return sorted_range<iterator>(first, (last < first) ? first : last);
+        }
+
+        /// <summary>
+        /// Entfernt alle Elemente im Bereich [first, last) mit einer einzigen Verschiebung des Rests.
+        /// </summary>
+        /// <returns>Ein Iterator auf das Element nach dem entfernten Bereich.</returns>
+        iterator erase_range(const iterator& first, const iterator& last) {
+            if (m_bBuckets && first != last) {
+                size_t removed[256] = {};
+                for (auto it = first; it != last; ++it) removed[bucketOf(*it)]++;
+                size_t sum = 0;
+                for (size_t key = 0; key < 256; key++) {
+                    sum += removed[key];
+                    m_vecBucketEnd[key] -= sum;
+                }
+            }
+            return m_vecData.erase(first, last);
+        }
+
+        /// <summary>
+        /// Entfernt alle Elemente, für die pred true liefert, in einem Durchlauf. Jedes Element wird höchstens einmal verschoben,
+        /// die übrigen Elemente behalten ihre Reihenfolge. pred wird für jedes Element genau einmal in Sortierreihenfolge aufgerufen.
+        /// </summary>
+        /// <returns>Die Anzahl entfernter Elemente.</returns>
+        template <class TPredicate>
+        size_t remove_if(TPredicate pred) {
+            size_t removed[256] = {};
+            auto out = m_vecData.begin();
+            for (auto it = m_vecData.begin(); it != m_vecData.end(); ++it) {
+                if (pred(*it)) {
+                    if (m_bBuckets) removed[bucketOf(*it)]++;
+                    continue;
+                }
+                if (out != it) *out = std::move(*it);
+                ++out;
+            }
+            size_t count = static_cast<size_t>(m_vecData.end() - out);
+            if (m_bBuckets && count > 0) {
+                size_t sum = 0;
+                for (size_t key = 0; key < 256; key++) {
+                    sum += removed[key];
+                    m_vecBucketEnd[key] -= sum;
+                }
+            }
+            m_vecData.erase(out, m_vecData.end());
+            return count;
+        }
+
         /// <summary>
         /// Entfernt ein Element aus der Datenstruktur an der durch den Iterator angegebenen Position.
         /// </summary>
         /// <param name="item">Ein Iterator, der auf das zu entfernende Element zeigt.</param>
         iterator remove(const iterator& item) {
+            if (m_bBuckets) {
+                for (size_t key = bucketOf(*item); key < 256; key++) m_vecBucketEnd[key]--;
+            }
             return m_vecData.erase(item);
         }
 
         /// <summary>
-        /// Fgt ein Element am Ende der Liste hinzu oder sortiert es ein, wenn Autosort aktiviert ist.
+        /// Fügt ein Element am Ende der Liste hinzu oder sortiert es ein, wenn Autosort aktiviert ist.
         /// </summary>
-        /// <param name="value">Das einzufgende Element.</param>
+        /// <param name="value">Das einzufügende Element.</param>
         void push_back(const T& value) {
             if (base_type::m_bAutosort) {
-                auto it = std::lower_bound(m_vecData.begin(), m_vecData.end(), value, m_funcCompare);
-                m_vecData.insert(it, value);
+                m_vecData.insert(insertPosition(value), value);
                 base_type::m_isSorted = true;
             }
             else {
                 m_vecData.push_back(value);
                 base_type::m_isSorted = false;
+                m_bBuckets = false;
             }
         }
 
         /// <summary>
-        /// Fgt ein Element am Ende der Liste hinzu oder sortiert es ein, abhngig von der Autosort-Einstellung.
+        /// Fügt ein Element am Ende der Liste hinzu oder sortiert es ein, abhängig von der Autosort-Einstellung.
         /// </summary>
-        /// <param name="value">Das hinzuzufgende Element.</param>
+        /// <param name="value">Das hinzuzufügende Element.</param>
         void push_back(T&& value) {
             if (base_type::m_bAutosort) {
-                auto it = std::lower_bound(m_vecData.begin(), m_vecData.end(), value, m_funcCompare);
+                auto it = insertPosition(value);
                 m_vecData.insert(it, std::move(value));
                 base_type::m_isSorted = true;
             }
             else {
                 m_vecData.push_back(std::move(value));
                 base_type::m_isSorted = false;
+                m_bBuckets = false;
             }
         }
         /// <summary>
-        /// Sortiert die Elemente in m_vecData mit der Vergleichsfunktion m_funcCompare.
+        /// Sortiert die Elemente in m_vecData, mit gesetztem Schlüssel per Radixsort, sonst mit der Vergleichsfunktion m_funcCompare.
         /// </summary>
         void sort() {
-            std::sort(m_vecData.begin(), m_vecData.end(), m_funcCompare);
+            if (m_funcKey)
+                radixSort();
+            else
+                std::sort(m_vecData.begin(), m_vecData.end(), m_funcCompare);
             base_type::m_isSorted = true;
         }
 
         /// <summary>
-        /// Lscht alle Elemente aus dem Container.
+        /// Löscht alle Elemente aus dem Container.
         /// </summary>
         void clear() {
             m_vecData.clear();
+            if (m_bBuckets) std::fill(m_vecBucketEnd.begin(), m_vecBucketEnd.end(), 0);
         }
 
         /// <summary>
-        /// Gibt die Anzahl der Elemente im Container zurck.
+        /// Gibt die Anzahl der Elemente im Container zurück.
         /// </summary>
         /// <returns>Die Anzahl der Elemente als Wert vom Typ size_t.</returns>
         size_t size() const {
@@ -165,30 +292,92 @@ namespace ses {
         }
 
         /// <summary>
-        /// Prft, ob die Datenstruktur leer ist.
+        /// Prüft, ob die Datenstruktur leer ist.
         /// </summary>
-        /// <returns>Gibt true zurck, wenn die Datenstruktur keine Elemente enthlt, andernfalls false.</returns>
+        /// <returns>Gibt true zurück, wenn die Datenstruktur keine Elemente enthält, andernfalls false.</returns>
         bool empty() const {
             return m_vecData.empty();
         }
 
         /// <summary>
-        /// Gibt das Element am angegebenen Index zurck.
+        /// Gibt das Element am angegebenen Index zurück.
         /// </summary>
-        /// <param name="index">Der Index des Elements, das zurckgegeben werden soll.</param>
+        /// <param name="index">Der Index des Elements, das zurückgegeben werden soll.</param>
         /// <returns>Eine konstante Referenz auf das Element am angegebenen Index.</returns>
         const T& operator[](size_t index) const {
             return m_vecData[index];
         }
 
         /// <summary>
-        /// Gibt eine Referenz auf das Element am angegebenen Index im Vektor zurck.
+        /// Gibt eine Referenz auf das Element am angegebenen Index im Vektor zurück.
         /// </summary>
         /// <param name="index">Der Index des Elements, das abgerufen werden soll.</param>
         /// <returns>Eine Referenz auf das Element am angegebenen Index.</returns>
         T& operator[](size_t index) {
             return m_vecData[index];
         }
+    private:
+        size_t bucketOf(const T& value) const {
+            return static_cast<size_t>(m_funcKey(value) & 0xFF);
+        }
+
+        size_t bucketBegin(size_t key) const {
+            return (key == 0) ? 0 : m_vecBucketEnd[key - 1];
+        }
+
+        /// <summary>
+        /// Bestimmt die Einfügeposition hinter allen gleichwertigen Elementen (Einfügereihenfolge wie bei sorted_list und sorted_skiplist)
+        /// und verschiebt dabei die Grenzen der Schlüsselwerte.
+        /// </summary>
+        iterator insertPosition(const T& value) {
+            if (!m_bBuckets)
+                return std::upper_bound(m_vecData.begin(), m_vecData.end(), value, m_funcCompare);
+
+            size_t key = bucketOf(value);
+            size_t pos = m_vecBucketEnd[key];
+            for (size_t next = key; next < 256; next++) m_vecBucketEnd[next]++;
+            return m_vecData.begin() + pos;
+        }
+
+        /// <summary>
+        /// Stabiler LSD-Radixsort über je 8 Bit des Schlüssels. Stellen, in denen alle Schlüssel übereinstimmen, werden übersprungen.
+        /// Bei Schlüsseln bis 8 Bit ist das ein einzelner Counting-Sort-Durchlauf, dessen Zähler die Grenzen der Schlüsselwerte liefern.
+        /// </summary>
+        void radixSort() {
+            const size_t count = m_vecData.size();
+            std::vector<uint64_t> keys(count);
+            for (size_t i = 0; i < count; i++) keys[i] = m_funcKey(m_vecData[i]);
+
+            std::vector<T> buffer(count);
+            std::vector<uint64_t> bufferKeys(count);
+            size_t offsets[256];
+            for (unsigned shift = 0; shift < m_uiKeyBits; shift += 8) {
+                std::fill(std::begin(offsets), std::end(offsets), 0);
+                for (size_t i = 0; i < count; i++) offsets[(keys[i] >> shift) & 0xFF]++;
+                if (count > 0 && offsets[(keys[0] >> shift) & 0xFF] == count) continue;
+
+                size_t sum = 0;
+                for (size_t& offset : offsets) {
+                    size_t size = offset;
+                    offset = sum;
+                    sum += size;
+                }
+                for (size_t i = 0; i < count; i++) {
+                    size_t pos = offsets[(keys[i] >> shift) & 0xFF]++;
+                    buffer[pos] = std::move(m_vecData[i]);
+                    bufferKeys[pos] = keys[i];
+                }
+                m_vecData.swap(buffer);
+                keys.swap(bufferKeys);
+            }
+
+            m_bBuckets = m_uiKeyBits <= 8;
+            if (m_bBuckets) {
+                m_vecBucketEnd.assign(256, 0);
+                for (size_t i = 0; i < count; i++) m_vecBucketEnd[keys[i] & 0xFF]++;
+                for (size_t key = 1; key < 256; key++) m_vecBucketEnd[key] += m_vecBucketEnd[key - 1];
+            }
+        }
     private:
         /// <summary>
         /// Ein Vektor, der eine Sequenz von Elementen speichert.
@@ -198,5 +387,15 @@ namespace ses {
         /// Ein Funktionszeiger zum Vergleichen von Werten.
         /// </summary>
         compare_func_t m_funcCompare;
+        /// <summary>
+        /// Der optionale Sortierschlüssel und die Anzahl seiner genutzten Bits.
+        /// </summary>
+        key_func_t m_funcKey;
+        unsigned m_uiKeyBits;
+        /// <summary>
+        /// Ende jedes Schlüsselwerts in m_vecData, nur bei Schlüsseln bis 8 Bit und sortierten Daten gültig (m_bBuckets).
+        /// </summary>
+        std::vector<size_t> m_vecBucketEnd;
+        bool m_bBuckets;
     };
 }
\ No newline at end of file
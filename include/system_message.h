@@ -12,7 +12,7 @@ namespace ses {
 		/// Konstruiert ein message-Objekt mit Standardwerten.
 		/// </summary>
 		system_message(uint32_t system_id, uint8_t prio) 
-			: message(prio, 0, true, false), m_systemID(system_id) {}
+			: message(prio, 0, true, false), m_systemID(system_id) { set_typetag(system_id); }
 
 		virtual bool onMessageProcess(void* sender) = 0;
 
@@ -5,6 +5,7 @@
 #include "tool.h"
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <thread>
 #include "tool.h"
 #include <mutex>
@@ -13,7 +14,7 @@
 namespace ses {
 
     /// <summary>
-    /// Die Klasse timed_countlock implementiert einen Zhllock mit Timeout-Funktionalitt, der es ermglicht, Sperren mit einer maximalen Wartezeit zu verwalten.
+    /// Die Klasse timed_countlock implementiert einen Zähllock mit Timeout-Funktionalität, der es ermöglicht, Sperren mit einer maximalen Wartezeit zu verwalten.
     /// </summary>
     class SES_API timed_countlock {
     public:
@@ -21,36 +22,62 @@ namespace ses {
         /// Erzeugt ein timed_countlock-Objekt mit einer angegebenen Timeout-Dauer in Millisekunden.
         /// </summary>
         /// <param name="ms">Die Timeout-Dauer in Millisekunden.</param>
-        timed_countlock(uint64_t ms) : m_ulTimeOut(ms), m_ulLastTime(0), m_iLocks(0) {  }
+        timed_countlock(uint64_t ms) : m_ulTimeOut(ms), m_ulLastTime(0), m_iLocks(0), m_bExclusive(false) {  }
 
         /// <summary>
-        /// Erhht den Sperrzhler atomar und aktualisiert die Zeit des letzten Zugriffs.
+        /// Erhöht den Sperrzähler atomar und aktualisiert die Zeit des letzten Zugriffs. Solange ein Halter exklusiv ist, wartet add.
         /// </summary>
         void add() {
-            const std::lock_guard<std::mutex> lock(m_ms);
+            std::unique_lock<std::mutex> lock(m_ms);
 
+            m_cv.wait(lock, [this] { return !m_bExclusive; });
             m_iLocks++;
             m_ulLastTime = tool::now();
         }
         /// <summary>
-        /// Gibt das Sperrobjekt frei und prft, ob keine Sperren mehr vorhanden sind.
+        /// Gibt das Sperrobjekt frei und prüft, ob keine Sperren mehr vorhanden sind.
         /// </summary>
-        /// <returns>Gibt true zurck, wenn nach dem Freigeben keine Sperren mehr vorhanden sind, andernfalls false.</returns>
+        /// <returns>Gibt true zurück, wenn nach dem Freigeben keine Sperren mehr vorhanden sind, andernfalls false.</returns>
         bool release() {
             const std::lock_guard<std::mutex> lock(m_ms);
 
             if (m_iLocks == 0) return false;
             m_iLocks--;
-            return m_iLocks == 0;
+            if (m_iLocks != 0) return false;
+            m_bExclusive = false;
+            m_cv.notify_all();
+            return true;
+        }
+
+        /// <summary>
+        /// Versucht ohne Warten, als einziger Halter vorübergehend exklusiv zu werden. Die Exklusivität ist ein Zustand des Zählers, m_ms ist danach wieder frei;
+        /// bis downgrade warten nur add und try_lock.
+        /// </summary>
+        /// <returns>Gibt true zurück, wenn der Aufrufer der einzige Halter ist, andernfalls false.</returns>
+        bool try_upgrade() {
+            const std::lock_guard<std::mutex> lock(m_ms);
+
+            if (m_iLocks != 1 || m_bExclusive) return false;
+            m_bExclusive = true;
+            return true;
+        }
+        /// <summary>
+        /// Beendet die mit try_upgrade erworbene Exklusivität.
+        /// </summary>
+        void downgrade() {
+            const std::lock_guard<std::mutex> lock(m_ms);
+
+            m_bExclusive = false;
+            m_cv.notify_all();
         }
 
         /// <summary>
         /// Versucht, ein Schloss innerhalb einer maximalen Wartezeit zu erwerben.
         /// </summary>
         /// <param name="max_wait_ms">Die maximale Wartezeit in Millisekunden, um das Schloss zu erwerben.</param>
-        /// <returns>Gibt true zurck, wenn das Schloss erfolgreich innerhalb der Wartezeit erworben wurde, andernfalls false.</returns>
+        /// <returns>Gibt true zurück, wenn das Schloss erfolgreich innerhalb der Wartezeit erworben wurde, andernfalls false.</returns>
         bool try_lock(uint64_t max_wait_ms) {
-            const std::lock_guard<std::mutex> lock(m_ms);
+            std::unique_lock<std::mutex> lock(m_ms);
 
             uint64_t start = tool::now();
             while (true) {
@@ -58,6 +85,7 @@ namespace ses {
 
                 if (m_iLocks == 0) {
                     m_iLocks++;
+                    m_bExclusive = true;
                     m_ulLastTime = tool::now();
                     return true;
                 }
@@ -67,7 +95,8 @@ namespace ses {
                     return false;
                 }
 
-                std::this_thread::sleep_for(std::chrono::milliseconds(5)); // Kurzes Warten vor nchster Prfung
+                // Kurzes Warten vor nächster Prüfung, m_ms ist dabei frei, damit release die Halter abbauen kann
+                m_cv.wait_for(lock, std::chrono::milliseconds(5));
             }
         }
 
@@ -75,7 +104,7 @@ namespace ses {
     private:
         
         /// <summary>
-        /// berprft, ob ein Timeout berschritten wurde, und dekrementiert gegebenenfalls einen Sperrzhler.
+        /// Überprüft, ob ein Timeout überschritten wurde, und dekrementiert gegebenenfalls einen Sperrzähler.
         /// </summary>
         void check_timeout() {
             if (m_iLocks == 0) return;
@@ -83,13 +112,16 @@ namespace ses {
             uint64_t now = tool::now();
             uint64_t last = m_ulLastTime;
             if (m_iLocks > 0 && now > last + m_ulTimeOut) {
-                // Timeout berschritten, Counter dekrementieren
+                // Timeout überschritten, Counter dekrementieren
                 m_iLocks--;
                 m_ulLastTime = now;
+                if (m_iLocks == 0) m_bExclusive = false;
             }
         }
     private:
         std::mutex m_ms;
+        std::condition_variable m_cv;
+        bool m_bExclusive;        // Ein try_lock- oder try_upgrade-Halter arbeitet allein, add wartet
         volatile  uint32_t m_iLocks;
         const uint64_t m_ulTimeOut;
         uint64_t m_ulLastTime;
@@ -6,17 +6,66 @@
 
 #include "config.h"
 
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#include <emmintrin.h>
+#include <intrin.h>
+#endif
+
 namespace ses {
 
     class SES_API tool {
     public:
         /// <summary>
-        /// Gibt die aktuelle Zeit seit dem Start des Programms in Millisekunden zurck.
+        /// Gibt die aktuelle Zeit seit dem Start des Programms in Millisekunden zurück.
         /// </summary>
         /// <returns>Die Anzahl der Millisekunden seit dem Start des Programms als uint64_t.</returns>
         static uint64_t now() {
             return std::chrono::duration_cast<std::chrono::milliseconds>(
                 std::chrono::steady_clock::now().time_since_epoch()).count();
         }
+
+        /// <summary>
+        /// Lädt die Cache-Zeile der angegebenen Adresse vorab. Die Adresse muss nicht gültig sein.
+        /// </summary>
+        /// <param name="addr">Die Adresse.</param>
+        static void prefetch(const void* addr) {
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+            _mm_prefetch(static_cast<const char*>(addr), _MM_HINT_T0);
+#elif defined(__GNUC__) || defined(__clang__)
+            __builtin_prefetch(addr);
+#else
+            (void)addr;
+#endif
+        }
+
+        /// <summary>
+        /// Gibt den Index des höchsten gesetzten Bits zurück (abgerundeter Zweierlogarithmus). value muss größer als 0 sein.
+        /// </summary>
+        static unsigned floor_log2(uint64_t value) {
+#if defined(_MSC_VER) && defined(_M_X64)
+            unsigned long index;
+            _BitScanReverse64(&index, value);
+            return static_cast<unsigned>(index);
+#elif defined(__GNUC__) || defined(__clang__)
+            return 63u - static_cast<unsigned>(__builtin_clzll(value));
+#else
+            unsigned index = 0;
+            while (value >>= 1) index++;
+            return index;
+#endif
+        }
+
+        /// <summary>
+        /// Kennzeichnet eine Warteschleife für den Prozessor (pause), damit sie weniger Energie und Rechenzeit des Nachbar-Threads verbraucht.
+        /// </summary>
+        static void cpu_relax() {
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+            _mm_pause();
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__i386__) || defined(__x86_64__))
+            __builtin_ia32_pause();
+#elif (defined(__GNUC__) || defined(__clang__)) && defined(__aarch64__)
+            __asm__ __volatile__("yield");
+#endif
+        }
     };
 }
\ No newline at end of file
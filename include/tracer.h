@@ -0,0 +1,133 @@
+// SPDX-License-Identifier: EUPL-1.2
+
+#pragma once
+
+#include "config.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ses {
+
+    /// <summary>
+    /// Stationen im Lebenslauf einer Nachricht, die der tracer aufzeichnet.
+    /// </summary>
+    enum class trace_event : uint8_t {
+        /// <summary>Die Nachricht wurde eingefügt oder hat eine wartende ersetzt.</summary>
+        post = 0,
+        /// <summary>Die Nachricht wurde aus einem Handler gepostet und im Thread gepuffert.</summary>
+        deferred,
+        /// <summary>Die Nachricht wurde beim Posten abgelehnt (Kapazität, early drop).</summary>
+        reject,
+        /// <summary>Die Nachricht wurde zugunsten einer wichtigeren entfernt.</summary>
+        evict,
+        /// <summary>Ein Handler beginnt die Verarbeitung.</summary>
+        handler_begin,
+        /// <summary>Der Handler ist zurückgekehrt.</summary>
+        handler_end,
+        /// <summary>Die Verarbeitung ist fehlgeschlagen, die Nachricht wird erneut versucht oder verworfen.</summary>
+        discard,
+        /// <summary>Die Lebensdauer der Nachricht ist abgelaufen.</summary>
+        expire,
+        /// <summary>Die Nachricht wurde in endProcessMessages aus der Warteschlange entfernt.</summary>
+        remove
+    };
+
+    /// <summary>
+    /// Ein aufgezeichnetes Ereignis.
+    /// </summary>
+    struct trace_record {
+        uint64_t time;      // Nanosekunden, steady_clock
+        uint64_t id;        // message::id::full
+        uint32_t thread;    // Laufende Nummer des aufzeichnenden Threads
+        trace_event event;
+        uint8_t priority;
+        std::atomic<uint64_t> sequence; // Position + 1, zuletzt geschrieben; erkennt überschriebene Einträge beim Auslesen
+    };
+
+    /// <summary>
+    /// Zeichnet den Lebenslauf von Nachrichten in Ringpuffern je Thread auf, ohne Sperren auf dem Schreibpfad. Über das Makro
+    /// SES_TRACE in config.h werden die Aufzeichnungspunkte des eventmanager einkompiliert, ohne das Makro kosten sie nichts.
+    /// Ausgewählt wird je Nachrichten-ID, sodass eine Nachricht entweder vollständig oder gar nicht aufgezeichnet wird.
+    /// </summary>
+    class SES_API tracer {
+    public:
+        /// <summary>
+        /// Gibt den prozessweiten tracer zurück.
+        /// </summary>
+        static tracer& instance();
+
+        tracer(const tracer&) = delete;
+        tracer& operator=(const tracer&) = delete;
+
+        /// <summary>
+        /// Schaltet die Aufzeichnung ein oder aus (Standard: aus).
+        /// </summary>
+        void set_enabled(bool enabled) { m_bEnabled.store(enabled, std::memory_order_relaxed); }
+        bool is_enabled() const { return m_bEnabled.load(std::memory_order_relaxed); }
+        /// <summary>
+        /// Zeichnet nur jede n-te Nachricht auf, ausgewählt über einen Hash der ID.
+        /// </summary>
+        /// <param name="every">1 = alle Nachrichten (Standard).</param>
+        void set_sampling(uint32_t every) { m_uiSampling.store((every == 0) ? 1 : every, std::memory_order_relaxed); }
+        /// <summary>
+        /// Setzt die Größe der Ringpuffer neu angelegter Threads. Wird auf eine Zweierpotenz aufgerundet.
+        /// </summary>
+        /// <param name="records">Die Anzahl Einträge je Thread (Standard: 65536).</param>
+        void set_capacity(size_t records);
+
+        /// <summary>
+        /// Zeichnet ein Ereignis im Ringpuffer des aufrufenden Threads auf. Ist der Puffer voll, wird der älteste Eintrag überschrieben.
+        /// </summary>
+        void record(trace_event event, uint64_t id, uint8_t priority) {
+            if (!is_enabled()) return;
+            uint32_t every = m_uiSampling.load(std::memory_order_relaxed);
+            if (every > 1 && ((id * 0x9E3779B97F4A7C15ull) >> 32) % every != 0) return;
+            write(event, id, priority);
+        }
+
+        /// <summary>
+        /// Schreibt alle gepufferten Ereignisse im Chrome-Trace-Format (chrome://tracing, Perfetto).
+        /// Die Lebensdauer einer Nachricht erscheint als asynchroner Abschnitt, Handler-Aufrufe als Abschnitte ihres Threads.
+        /// </summary>
+        /// <returns>Die Anzahl geschriebener Ereignisse.</returns>
+        size_t dump_chrome(std::ostream& out) const;
+        /// <summary>
+        /// Schreibt alle gepufferten Ereignisse im Chrome-Trace-Format in eine Datei.
+        /// </summary>
+        /// <returns>Gibt true zurück, wenn die Datei geschrieben wurde, andernfalls false.</returns>
+        bool dump_chrome(const std::string& path) const;
+        /// <summary>
+        /// Verwirft alle gepufferten Ereignisse.
+        /// </summary>
+        void clear();
+    private:
+        struct ring {
+            std::unique_ptr<trace_record[]> records;
+            size_t mask;
+            uint32_t thread;
+            std::atomic<uint64_t> head;
+            std::atomic<uint64_t> floor; // Erste gültige Position nach clear
+        };
+
+        tracer();
+        void write(trace_event event, uint64_t id, uint8_t priority);
+        ring* local_ring();
+    private:
+        std::atomic<bool> m_bEnabled;
+        std::atomic<uint32_t> m_uiSampling;
+        size_t m_ulCapacity;
+        mutable std::mutex m_mtxRings;
+        std::vector<std::shared_ptr<ring>> m_vecRings; // Ringe beendeter Threads bleiben bis zum Auslesen erhalten
+    };
+}
+
+#ifdef SES_TRACE
+#define SES_TRACE_EVENT(event, msg) ::ses::tracer::instance().record(::ses::trace_event::event, (msg)->get_id().full, (msg)->get_priority())
+#else
+#define SES_TRACE_EVENT(event, msg) ((void)0)
+#endif
@@ -0,0 +1,208 @@
+// SPDX-License-Identifier: EUPL-1.2
+
+#include "balancer.h"
+#include <algorithm>
+
+namespace ses {
+
+    balancer::balancer(eventmanager& manager, size_t workers, uint64_t intervalMs)
+        : m_manager(manager), m_ulInterval(intervalMs), m_ulLastTime(tool::now()), m_dSmoothing(0.5), m_dHysteresis(0.1), m_ulHistoryLimit(64)
+    {
+        workers = std::min<size_t>(std::max<size_t>(workers, 1), 256);
+        std::fill(std::begin(m_aLoad), std::end(m_aLoad), 0.0);
+        std::fill(std::begin(m_aCost), std::end(m_aCost), 0.0);
+
+        // Gleichmäßige Anfangsverteilung
+        for (size_t worker = 0; worker < workers; worker++) {
+            range_assignment range;
+            range.from = static_cast<uint8_t>(worker * 256 / workers);
+            range.to = static_cast<uint8_t>((worker + 1) * 256 / workers - 1);
+            m_vecRanges.push_back(range);
+        }
+
+        m_manager.set_statistics(true);
+        m_manager.get_statistics(m_stats);
+    }
+
+    bool balancer::processMessages(size_t worker) {
+        update();
+
+        // Während des Zyklus bleibt der Bereich des Workers bestehen
+        std::shared_lock<std::shared_timed_mutex> lock(m_mtxRanges);
+        range_assignment range = m_vecRanges[worker % m_vecRanges.size()];
+        m_manager.beginMessages();
+        bool result = m_manager.processMessages(range.from, range.to);
+        m_manager.endProcessMessages();
+        return result;
+    }
+
+    bool balancer::update() {
+        if (tool::now() - m_ulLastTime < m_ulInterval) return false;
+        return rebalance();
+    }
+
+    bool balancer::rebalance() {
+        // Messen nur einmal gleichzeitig, weitere Worker verarbeiten währenddessen mit den alten Bereichen
+        std::unique_lock<std::mutex> measureLock(m_mtxMeasure, std::try_to_lock);
+        if (!measureLock.owns_lock()) return false;
+
+        uint64_t now = tool::now();
+        measure(now);
+
+        std::vector<range_assignment> ranges = partition();
+        double before = imbalance(m_vecRanges);
+        double after = imbalance(ranges);
+
+        auto max_load = [this](const std::vector<range_assignment>& assignment) {
+            double result = 0;
+            for (auto& range : assignment) {
+                double sum = 0;
+                for (int prio = range.from; prio <= range.to; prio++) sum += m_aLoad[prio];
+                result = std::max(result, sum);
+            }
+            return result;
+        };
+        if (!(max_load(ranges) < max_load(m_vecRanges) * (1.0 - m_dHysteresis)))
+            return false;
+
+        {
+            std::unique_lock<std::shared_timed_mutex> lock(m_mtxRanges);
+            m_vecRanges = ranges;
+        }
+        rebalance_record record = { now, ranges, before, after };
+        m_deqHistory.push_back(std::move(record));
+        while (m_deqHistory.size() > m_ulHistoryLimit) m_deqHistory.pop_front();
+        return true;
+    }
+
+    void balancer::measure(uint64_t now) {
+        priority_stats current;
+        m_manager.get_statistics(current);
+        double seconds = std::max<uint64_t>(now - m_ulLastTime, 1) / 1000.0;
+
+        // Mittlere Handler-Dauer je Priorität, Prioritäten ohne Aufrufe behalten ihren alten Wert
+        double costSum = 0;
+        size_t costCount = 0;
+        for (int prio = 0; prio < 256; prio++) {
+            uint64_t processed = current.processed[prio] - m_stats.processed[prio];
+            if (processed > 0) {
+                double cost = static_cast<double>(current.cost_ns[prio] - m_stats.cost_ns[prio]) / processed;
+                m_aCost[prio] = (m_aCost[prio] == 0) ? cost : m_dSmoothing * cost + (1.0 - m_dSmoothing) * m_aCost[prio];
+            }
+            if (m_aCost[prio] > 0) {
+                costSum += m_aCost[prio];
+                costCount++;
+            }
+        }
+        // Noch nie verarbeitete Prioritäten werden mit der mittleren Dauer aller anderen geschätzt
+        double fallback = (costCount > 0) ? costSum / costCount : 1.0;
+
+        for (int prio = 0; prio < 256; prio++) {
+            double rate = (current.arrivals[prio] - m_stats.arrivals[prio]) / seconds;
+            double cost = (m_aCost[prio] > 0) ? m_aCost[prio] : fallback;
+            m_aLoad[prio] = m_dSmoothing * rate * cost + (1.0 - m_dSmoothing) * m_aLoad[prio];
+        }
+        m_stats = current;
+        m_ulLastTime = now;
+    }
+
+    double balancer::imbalance(const std::vector<range_assignment>& ranges) const {
+        double total = 0, highest = 0;
+        for (auto& range : ranges) {
+            double sum = 0;
+            for (int prio = range.from; prio <= range.to; prio++) sum += m_aLoad[prio];
+            total += sum;
+            highest = std::max(highest, sum);
+        }
+        return (total > 0) ? highest * ranges.size() / total : 1.0;
+    }
+
+    std::vector<range_assignment> balancer::partition() const {
+        const size_t workers = m_vecRanges.size();
+        double total = 0, largest = 0;
+        for (double load : m_aLoad) {
+            total += load;
+            largest = std::max(largest, load);
+        }
+        if (total <= 0) return m_vecRanges;
+
+        // Kleinste Obergrenze je Worker, mit der sich die Prioritäten in höchstens workers zusammenhängende Bereiche teilen lassen
+        auto fits = [this, workers](double limit) {
+            size_t used = 1;
+            double sum = 0;
+            for (double load : m_aLoad) {
+                if (sum + load > limit) {
+                    if (++used > workers) return false;
+                    sum = load;
+                }
+                else
+                    sum += load;
+            }
+            return true;
+        };
+        double low = largest, high = total;
+        for (int step = 0; step < 64 && high - low > total * 1e-9; step++) {
+            double mid = (low + high) / 2;
+            if (fits(mid))
+                high = mid;
+            else
+                low = mid;
+        }
+
+        // Bereiche gierig bis zur Obergrenze füllen, jedem folgenden Worker bleibt mindestens eine Priorität
+        std::vector<range_assignment> ranges;
+        int from = 0;
+        for (size_t worker = 0; worker < workers; worker++) {
+            int to = from;
+            if (worker + 1 == workers)
+                to = 255;
+            else {
+                double sum = m_aLoad[from];
+                int last = 255 - static_cast<int>(workers - worker - 1);
+                while (to < last && sum + m_aLoad[to + 1] <= high) {
+                    to++;
+                    sum += m_aLoad[to];
+                }
+            }
+            ranges.push_back(range_assignment{ static_cast<uint8_t>(from), static_cast<uint8_t>(to) });
+            from = to + 1;
+        }
+        return ranges;
+    }
+
+    range_assignment balancer::get_range(size_t worker) const {
+        std::shared_lock<std::shared_timed_mutex> lock(m_mtxRanges);
+        return m_vecRanges[worker % m_vecRanges.size()];
+    }
+
+    std::vector<range_assignment> balancer::get_assignment() const {
+        std::shared_lock<std::shared_timed_mutex> lock(m_mtxRanges);
+        return m_vecRanges;
+    }
+
+    std::vector<rebalance_record> balancer::get_history() const {
+        const std::lock_guard<std::mutex> lock(m_mtxMeasure);
+        return std::vector<rebalance_record>(m_deqHistory.begin(), m_deqHistory.end());
+    }
+
+    double balancer::get_load(uint8_t prio) const {
+        const std::lock_guard<std::mutex> lock(m_mtxMeasure);
+        return m_aLoad[prio];
+    }
+
+    void balancer::set_smoothing(double alpha) {
+        const std::lock_guard<std::mutex> lock(m_mtxMeasure);
+        m_dSmoothing = std::min(std::max(alpha, 0.0), 1.0);
+    }
+
+    void balancer::set_hysteresis(double ratio) {
+        const std::lock_guard<std::mutex> lock(m_mtxMeasure);
+        m_dHysteresis = std::min(std::max(ratio, 0.0), 1.0);
+    }
+
+    void balancer::set_history_limit(size_t limit) {
+        const std::lock_guard<std::mutex> lock(m_mtxMeasure);
+        m_ulHistoryLimit = limit;
+        while (m_deqHistory.size() > m_ulHistoryLimit) m_deqHistory.pop_front();
+    }
+}
@@ -58,7 +58,7 @@ public:
 int main()
 {
     ses::eventmanager manager(300);
-    manager.postMessage(std::shared_ptr<hallo_world_message>(new hallo_world_message()), 0);
+    manager.postMessage(ses::make_message<hallo_world_message>(), 0);
 
     if (manager.beginMessages()) {
         manager.processMessages(1, 7);
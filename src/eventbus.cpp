@@ -0,0 +1,122 @@
+// SPDX-License-Identifier: EUPL-1.2
+
+#include "eventbus.h"
+#include <algorithm>
+
+namespace ses {
+
+    eventbus::eventbus(size_t batchSize, uint64_t maxWaitTime, uint64_t maxLinger)
+        : m_ulBatchSize(std::max<size_t>(batchSize, 1)), m_ulMaxWait(maxWaitTime), m_ulMaxLinger(maxLinger), m_ulUnrouted(0), m_ulRejected(0)
+    { }
+
+    eventbus::~eventbus() {
+        flush();
+    }
+
+    size_t eventbus::attach(eventmanager& manager) {
+        std::unique_ptr<target> entry(new target());
+        entry->manager = &manager;
+        entry->ulFirstQueued = 0;
+        m_vecTargets.push_back(std::move(entry));
+        return m_vecTargets.size() - 1;
+    }
+
+    void eventbus::add_route(const route_rule& rule) {
+        m_vecRules.push_back(rule);
+    }
+
+    void eventbus::clear_routes() {
+        m_vecRules.clear();
+    }
+
+    const route_rule* eventbus::findRoute(const message& msg) const {
+        message::id_type id = msg.get_id();
+        for (const route_rule& rule : m_vecRules) {
+            bool match;
+            switch (rule.match) {
+            case route_match::internal: match = id.is_internal(); break;
+            case route_match::external: match = !id.is_internal(); break;
+            case route_match::group: match = id.is_group(); break;
+            case route_match::single: match = !id.is_group(); break;
+            case route_match::system_id: match = id.is_internal() && msg.get_typetag() >= rule.low && msg.get_typetag() <= rule.high; break;
+            case route_match::typetag: match = msg.get_typetag() >= rule.low && msg.get_typetag() <= rule.high; break;
+            default: match = true; break;
+            }
+            if (match && !rule.targets.empty()) return &rule;
+        }
+        return nullptr;
+    }
+
+    size_t eventbus::postMessage(const message_ptr& msg) {
+        const message_ptr& payload = forward_message::payload_of(msg);
+        const route_rule* rule = findRoute(*payload);
+        if (rule == nullptr) {
+            m_ulUnrouted++;
+            payload->onMessagePost(nullptr, false);
+            return 0;
+        }
+
+        if (rule->match == route_match::hash) {
+            // Fortlaufende IDs gleichmäßig streuen (Fibonacci-Hashing)
+            uint32_t hash = static_cast<uint32_t>((payload->get_id().raw_id() * 0x9E3779B97F4A7C15ull) >> 32);
+            enqueue(rule->targets[hash % rule->targets.size()], payload);
+            return 1;
+        }
+
+        enqueue(rule->targets[0], payload);
+        if (payload->is_async()) return 1;
+        for (size_t i = 1; i < rule->targets.size(); i++)
+            enqueue(rule->targets[i], std::make_shared<forward_message>(payload));
+        return rule->targets.size();
+    }
+
+    void eventbus::enqueue(size_t index, message_ptr msg) {
+        target& entry = *m_vecTargets[index];
+        bool due;
+        {
+            uint64_t now = tool::now();
+            const std::lock_guard<std::mutex> lock(entry.mtxQueue);
+            if (entry.vecQueue.empty()) entry.ulFirstQueued = now;
+            entry.vecQueue.push_back(std::move(msg));
+            due = entry.vecQueue.size() >= m_ulBatchSize || (m_ulMaxLinger > 0 && now - entry.ulFirstQueued >= m_ulMaxLinger);
+        }
+        if (due) flush(index);
+    }
+
+    size_t eventbus::flush_due() {
+        if (m_ulMaxLinger == 0) return 0;
+        uint64_t now = tool::now();
+        size_t flushed = 0;
+        for (size_t index = 0; index < m_vecTargets.size(); index++) {
+            target& entry = *m_vecTargets[index];
+            bool due;
+            {
+                const std::lock_guard<std::mutex> lock(entry.mtxQueue);
+                due = !entry.vecQueue.empty() && now - entry.ulFirstQueued >= m_ulMaxLinger;
+            }
+            if (due) {
+                flush(index);
+                flushed++;
+            }
+        }
+        return flushed;
+    }
+
+    void eventbus::flush() {
+        for (size_t index = 0; index < m_vecTargets.size(); index++)
+            flush(index);
+    }
+
+    void eventbus::flush(size_t index) {
+        target& entry = *m_vecTargets[index];
+        const std::lock_guard<std::mutex> flushLock(entry.mtxFlush);
+        std::vector<message_ptr> batch;
+        {
+            const std::lock_guard<std::mutex> lock(entry.mtxQueue);
+            batch.swap(entry.vecQueue);
+        }
+        if (batch.empty()) return;
+        size_t accepted = entry.manager->postMessages(batch.data(), batch.size(), m_ulMaxWait);
+        m_ulRejected += batch.size() - accepted;
+    }
+}
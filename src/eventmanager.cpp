@@ -2,51 +2,790 @@
 
 #include "eventmanager.h"
 #include "sorted_vector.h" // Ensure the correct header for sorted_vector is included
+#include "tracer.h"
+#include "forward_message.h"
 
 namespace ses {
     static bool compare_message(const eventmanager::message_ptr& a, const eventmanager::message_ptr& b) {
-        return a->get_priority() < b->get_priority(); // kleiner = hhere Prioritt
+        return a->get_priority() < b->get_priority(); // kleiner = höhere Priorität
     }
 
+    static uint64_t deadline_of(const eventmanager::message_ptr& msg) {
+        return (msg->get_alivems() > 0) ? msg->get_timestamp() + msg->get_alivems() : UINT64_MAX;
+    }
+
+    static bool compare_deadline(const eventmanager::message_ptr& a, const eventmanager::message_ptr& b) {
+        return deadline_of(a) < deadline_of(b);
+    }
+
+    static bool compare_priority_deadline(const eventmanager::message_ptr& a, const eventmanager::message_ptr& b) {
+        if (a->get_priority() != b->get_priority())
+            return a->get_priority() < b->get_priority();
+        return deadline_of(a) < deadline_of(b);
+    }
+
+    // Sortierschlüssel mit derselben Ordnung wie die Vergleichsfunktionen, für Radixsort ohne Vergleiche
+    static uint64_t key_priority(const eventmanager::message_ptr& msg) {
+        return msg->get_priority();
+    }
+
+    static uint64_t key_deadline(const eventmanager::message_ptr& msg) {
+        return deadline_of(msg);
+    }
+
+    static uint64_t key_priority_deadline(const eventmanager::message_ptr& msg) {
+        // 56 Bit reichen für Millisekunden-Zeitstempel, "ohne Ablauf" wird auf den größten Wert abgebildet
+        return (static_cast<uint64_t>(msg->get_priority()) << 56) | std::min<uint64_t>(deadline_of(msg), (1ull << 56) - 1);
+    }
+
+    // Vergleichsnachricht für die Bereichssuche in der Warteschlange, wird nie eingereiht
+    class range_probe : public message {
+    public:
+        range_probe() : message(0, 0) {}
+        void onMessagePost(void*, bool) override {}
+        bool onMessageProcess(void*) override { return false; }
+        void onMessageDiscard(void*, uint64_t) override {}
+        void onMessageExpired(void*, uint64_t) override {}
+    };
+
+    // Sortiert unter priority und priority_deadline vor jede Nachricht der Priorität prio
+    static const eventmanager::message_ptr& first_of_priority(uint8_t prio) {
+        static thread_local eventmanager::message_ptr probe = std::make_shared<range_probe>();
+        probe->set_priority(prio);
+        probe->set_timestamp(0);
+        probe->set_alivems(1);
+        return probe;
+    }
+
+    // Während processMessages gepostete Nachrichten des Threads, eingereiht erst in endProcessMessages
+    struct local_post {
+        eventmanager* owner;
+        eventmanager::message_ptr msg;
+    };
+    static thread_local eventmanager* t_pProcessing = nullptr;
+    static thread_local std::vector<local_post> t_vecLocalPosts;
+
+    // Markiert den Thread für die Dauer eines Durchlaufs als Verarbeiter, verschachtelte Durchläufe stellen den vorigen wieder her
+    struct processing_scope {
+        eventmanager* previous;
+        explicit processing_scope(eventmanager* manager) : previous(t_pProcessing) { t_pProcessing = manager; }
+        ~processing_scope() { t_pProcessing = previous; }
+    };
+
+    static uint64_t clock_us() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    static const uint32_t WAIT_SPIN_MIN = 16;
+    static const uint32_t WAIT_SPIN_MAX = 16384;
+
     eventmanager::eventmanager(uint64_t timedWaitMax)
-        : m_vecMessages(true, compare_message), m_ctLock(timedWaitMax) // Autosort enabled
+        : m_vecMessages(true, compare_message), m_ctLock(timedWaitMax), m_pJournal(nullptr), m_pReclaimer(nullptr), m_pRecorder(nullptr), m_eOrder(order_policy::priority), m_funcOrder(compare_message), m_ulRandom(0x9E3779B97F4A7C15ull), // Autosort enabled
+          m_ulCount(0), m_ptrSnapshot(std::make_shared<queue_snapshot>()), m_ulSnapshotInterval(50), m_ulSnapshotTime(0), m_ulSnapshotVersion(0), m_bSnapshotDirty(false), m_ulChainLimit(0), m_bHandoff(false), m_bSweep(false),
+          m_uiWaiters(0), m_uiSpin(256), m_bStatistics(false), m_ptrAsync(std::make_shared<async_link>(this))
     {
+        std::fill(std::begin(m_aBandOf), std::end(m_aBandOf), -1);
+        std::fill(std::begin(m_aPrioCount), std::end(m_aPrioCount), 0);
+        for (auto& mask : m_aPrioMask) mask.store(0);
+        for (int prio = 0; prio < 256; prio++) {
+            m_aArrivals[prio].store(0);
+            m_aProcessed[prio].store(0);
+            m_aCostNs[prio].store(0);
+        }
+        m_vecMessages.set_key(key_priority, 8);
+        m_vecMessages.sort(); // Schaltet die Grenzen je Priorität ein, auf dem leeren Vektor ohne Kosten
     }
 
-    void eventmanager::postMessage(message_ptr msg, uint64_t maxWaitTime) {
+    eventmanager::~eventmanager() {
+        m_ptrAsync->revoke();
+    }
+
+    post_result eventmanager::postMessage(message_ptr msg, uint64_t maxWaitTime) {
+        if (t_pProcessing == this) {
+            // Aus einem Handler: der Durchlauf hält den Lock bereits, daher ohne Synchronisation puffern
+            t_vecLocalPosts.push_back(local_post{ this, msg });
+            msg->set_postresult(post_result::deferred);
+            SES_TRACE_EVENT(deferred, msg);
+            return post_result::deferred;
+        }
         if (m_ctLock.try_lock(maxWaitTime)) 
         {
-            msg->onMessagePost(this, true);
-            m_vecMessages.push_back(msg);
+            if (m_bSweep.exchange(false)) sweepMessages();
+            if (m_bHandoff.load(std::memory_order_acquire)) insertHandoff();
+            post_result result = insertMessage(msg, true);
+            std::shared_ptr<queue_snapshot> snapshot = collectSnapshot(false);
+            std::vector<message_ptr> garbage;
+            garbage.swap(m_vecGarbage);
+            std::vector<post_notice> notices;
+            notices.swap(m_vecNotices);
             m_ctLock.release();  // Lock wieder freigeben!
+            publishSnapshot(std::move(snapshot));
+            commitJournal(false);
+            deliverNotices(notices);
+            retireMessages(garbage);
+            return result;
         }
         else 
         {
+            msg->set_postresult(post_result::timeout);
             msg->onMessagePost(this, false);
+            return post_result::timeout;
+        }
+    }
+
+    size_t eventmanager::postMessages(const message_ptr* msgs, size_t count, uint64_t maxWaitTime) {
+        size_t accepted = 0;
+        if (count == 0) return 0;
+        if (t_pProcessing == this) {
+            for (size_t i = 0; i < count; i++) postMessage(msgs[i], maxWaitTime);
+            return count;
+        }
+        if (m_ctLock.try_lock(maxWaitTime))
+        {
+            if (m_bSweep.exchange(false)) sweepMessages();
+            if (m_bHandoff.load(std::memory_order_acquire)) insertHandoff();
+            for (size_t i = 0; i < count; i++) {
+                post_result result = insertMessage(msgs[i], true);
+                if (result == post_result::added || result == post_result::coalesced) accepted++;
+            }
+            std::shared_ptr<queue_snapshot> snapshot = collectSnapshot(false);
+            std::vector<message_ptr> garbage;
+            garbage.swap(m_vecGarbage);
+            std::vector<post_notice> notices;
+            notices.swap(m_vecNotices);
+            m_ctLock.release();
+            publishSnapshot(std::move(snapshot));
+            commitJournal(false);
+            deliverNotices(notices);
+            retireMessages(garbage);
+        }
+        else
+        {
+            for (size_t i = 0; i < count; i++) {
+                msgs[i]->set_postresult(post_result::timeout);
+                msgs[i]->onMessagePost(this, false);
+            }
+        }
+        return accepted;
+    }
+
+    post_result eventmanager::insertMessage(const message_ptr& msg, bool notify) {
+        post_result result = post_result::coalesced;
+        if (msg->get_coalescekey() == 0 || !coalesceMessage(msg)) {
+            result = admitMessage(msg);
+            if (result == post_result::added) {
+                m_vecMessages.push_back(msg);
+                trackMessage(msg->get_priority(), 1);
+                if (msg->get_coalescekey() != 0)
+                    m_mapCoalesce[msg->get_coalescekey()] = msg;
+                if (m_pJournal != nullptr)
+                    m_pJournal->appendPost(*msg);
+            }
+        }
+        msg->set_postresult(result);
+        if (result == post_result::added || result == post_result::coalesced) {
+            m_bSnapshotDirty.store(true, std::memory_order_relaxed);
+            notifyArrival(msg->get_priority());
+            SES_TRACE_EVENT(post, msg);
+            accountPost(*msg);
+        }
+        else
+            SES_TRACE_EVENT(reject, msg);
+        if (notify)
+            msg->onMessagePost(this, result == post_result::added || result == post_result::coalesced);
+        return result;
+    }
+
+    void eventmanager::mergeLocalPosts(std::vector<message_ptr>& garbage) {
+        size_t kept = 0;
+        {
+            const std::lock_guard<std::mutex> lock(m_mtxHandoff);
+            for (size_t i = 0; i < t_vecLocalPosts.size(); i++) {
+                local_post& entry = t_vecLocalPosts[i];
+                if (entry.owner != this) {
+                    // Puffer eines verschachtelten Durchlaufs eines anderen eventmanagers
+                    if (kept != i) t_vecLocalPosts[kept] = std::move(entry);
+                    kept++;
+                    continue;
+                }
+                if (entry.msg->is_marked()) {
+                    // Im selben Durchlauf abgeschlossen
+                    SES_TRACE_EVENT(remove, entry.msg);
+                    garbage.push_back(std::move(entry.msg));
+                    continue;
+                }
+                m_vecHandoff.push_back(std::move(entry.msg));
+            }
+            t_vecLocalPosts.resize(kept);
+            if (!m_vecHandoff.empty()) m_bHandoff.store(true, std::memory_order_release);
+        }
+    }
+
+    void eventmanager::insertHandoff() {
+        std::vector<message_ptr> handoff;
+        {
+            const std::lock_guard<std::mutex> lock(m_mtxHandoff);
+            handoff.swap(m_vecHandoff);
+            m_bHandoff.store(false, std::memory_order_relaxed);
+        }
+        for (auto& msg : handoff) {
+            // Bereits verkettet angekündigte, aber fehlgeschlagene Nachrichten nicht erneut melden, eine Ablehnung aber als Verwerfen
+            bool announced = msg->get_postresult() != post_result::deferred;
+            post_result result = insertMessage(msg, false);
+            bool accepted = result == post_result::added || result == post_result::coalesced;
+            if (!announced)
+                m_vecNotices.push_back(post_notice{ msg, post_notice::post, accepted });
+            else if (!accepted)
+                m_vecNotices.push_back(post_notice{ msg, post_notice::discard, false });
+        }
+    }
+
+    void eventmanager::deliverNotices(std::vector<post_notice>& notices) {
+        // Ohne Lock: die Rückmeldungen dürfen selbst posten oder den eventmanager abfragen
+        for (auto& notice : notices) {
+            switch (notice.kind) {
+            case post_notice::discard:
+                notice.msg->onMessageDiscard(this, tool::now());
+                break;
+            case post_notice::expire:
+                notice.msg->onMessageExpired(this, tool::now());
+                break;
+            default:
+                notice.msg->onMessagePost(this, notice.accepted);
+                break;
+            }
+        }
+    }
+
+    void eventmanager::sweepMessages() {
+        uint64_t now = tool::now();
+        uint64_t ready[4] = { 0, 0, 0, 0 };
+        // In einem Durchlauf entfernen: Unter order_policy::deadline liegen verarbeitete und abgelaufene Nachrichten vorn,
+        // einzelnes Entfernen würde den Rest für jede davon verschieben
+        m_vecMessages.remove_if([&](message_ptr& msg) {
+            if (!msg->is_marked() && !msg->is_pending() && msg->is_expired(now)) {
+                // Abgelaufen, aber in keinem bearbeiteten Prioritätsbereich
+                SES_TRACE_EVENT(expire, msg);
+                msg->set_runned();
+                m_vecNotices.push_back(post_notice{ msg, post_notice::expire, false });
+            }
+            if (msg->is_marked() == true) {
+                trackMessage(msg->get_priority(), -1);
+                unindexMessage(msg);
+                if (m_pJournal != nullptr)
+                    m_pJournal->appendTombstone(*msg);
+                SES_TRACE_EVENT(remove, msg);
+                // Die letzte Referenz erst nach dem Freigeben des Locks abgeben
+                m_vecGarbage.push_back(msg);
+                return true;
+            }
+            if (!msg->is_pending()) ready[msg->get_priority() >> 6] |= 1ull << (msg->get_priority() & 63);
+            return false;
+        });
+        m_vecDiscards.clear();
+
+        // Die Maske neu aufbauen: laufende asynchrone Nachrichten sind nicht bereit, bis ihr Abschluss gemeldet ist
+        const std::lock_guard<std::mutex> lock(m_mtxCompleted);
+        for (auto& entry : m_vecCompleted) ready[entry.first->get_priority() >> 6] |= 1ull << (entry.first->get_priority() & 63);
+        for (int word = 0; word < 4; word++) m_aPrioMask[word].store(ready[word], std::memory_order_release);
+    }
+
+    void eventmanager::tidyMessages() {
+        // Exklusiv nachholen, was kein endProcessMessages als einziger Halter erledigen konnte. Kommt ein anderer Halter zuvor,
+        // übernimmt dessen endProcessMessages bzw. postMessage.
+        if (!m_ctLock.try_lock(1)) return;
+        if (m_bSweep.exchange(false)) sweepMessages();
+        if (m_bHandoff.load(std::memory_order_acquire)) insertHandoff();
+        std::shared_ptr<queue_snapshot> snapshot = collectSnapshot(false);
+        std::vector<message_ptr> garbage;
+        garbage.swap(m_vecGarbage);
+        std::vector<post_notice> notices;
+        notices.swap(m_vecNotices);
+        m_ctLock.release();
+        publishSnapshot(std::move(snapshot));
+        commitJournal(false);
+        deliverNotices(notices);
+        retireMessages(garbage);
+    }
+
+    bool eventmanager::coalesceMessage(const message_ptr& msg) {
+        auto entry = m_mapCoalesce.find(msg->get_coalescekey());
+        if (entry == m_mapCoalesce.end())
+            return false;
+
+        message_ptr old = entry->second;
+        // Bereits verarbeitete oder laufende Nachrichten werden nicht mehr ersetzt
+        if (old->is_marked() || old->is_pending())
+            return false;
+
+        auto it = m_vecMessages.find(old);
+        if (it == m_vecMessages.end())
+            return false;
+
+        // Priorität beibehalten oder anheben, niemals absenken
+        if (msg->get_priority() >= old->get_priority())
+            msg->set_priority(old->get_priority());
+        else if (m_aBandOf[msg->get_priority()] != m_aBandOf[old->get_priority()] && admitMessage(msg) != post_result::added)
+            // Das Anheben wechselt das Kapazitätsband: ohne Platz dort bleibt die Nachricht in ihrem bisherigen Band
+            msg->set_priority(old->get_priority());
+
+        // An Ort und Stelle nur ersetzen, wenn die neue Nachricht in der Ordnung gleichwertig ist
+        if (!m_funcOrder(msg, old) && !m_funcOrder(old, msg)) {
+            *it = msg;
+        }
+        else {
+            m_vecMessages.remove(it);
+            m_vecMessages.push_back(msg);
+            trackMessage(old->get_priority(), -1);
+            trackMessage(msg->get_priority(), 1);
+        }
+        entry->second = msg;
+        if (m_pJournal != nullptr) {
+            m_pJournal->appendTombstone(*old);
+            m_pJournal->appendPost(*msg);
+        }
+        SES_TRACE_EVENT(remove, old);
+        m_vecNotices.push_back(post_notice{ old, post_notice::discard, false });
+        m_vecGarbage.push_back(std::move(old));
+        return true;
+    }
+
+    post_result eventmanager::admitMessage(const message_ptr& msg) {
+        int band = m_aBandOf[msg->get_priority()];
+        if (band < 0) return post_result::added;
+
+        capacity_band& entry = m_vecBands[band];
+        if (entry.policy == shed_policy::early_drop && entry.count >= entry.capacity / 2 && entry.count < entry.capacity) {
+            // Verwerfungswahrscheinlichkeit steigt linear von halber bis voller Kapazität
+            m_ulRandom ^= m_ulRandom << 13;
+            m_ulRandom ^= m_ulRandom >> 7;
+            m_ulRandom ^= m_ulRandom << 17;
+            size_t threshold = entry.capacity / 2;
+            if ((m_ulRandom % (entry.capacity - threshold)) < (entry.count - threshold))
+                return post_result::dropped;
+        }
+        if (entry.count < entry.capacity) return post_result::added;
+        if (entry.policy != shed_policy::evict_oldest) return post_result::capacity;
+
+        auto victim = m_vecMessages.end();
+        if (m_eOrder != order_policy::deadline) {
+            // Nach Priorität geordnet: nur den Bereich der niedrigsten belegten Priorität des Bands durchsuchen. Ein später überlappendes
+            // Band kann Prioritäten aus from..to übernommen haben, maßgeblich ist daher m_aBandOf.
+            for (int prio = entry.to; prio >= entry.from && prio >= msg->get_priority() && victim == m_vecMessages.end(); prio--) {
+                if (m_aPrioCount[prio] == 0 || m_aBandOf[prio] != band) continue;
+                for (auto it = m_vecMessages.lower_bound(first_of_priority(static_cast<uint8_t>(prio)));
+                     it != m_vecMessages.end() && (*it)->get_priority() == prio; ++it) {
+                    const message_ptr& cand = *it;
+                    if (cand->is_marked() || cand->is_pending()) continue;
+                    if (victim == m_vecMessages.end() || cand->get_timestamp() < (*victim)->get_timestamp())
+                        victim = it;
+                }
+            }
+        }
+        else {
+            for (auto it = m_vecMessages.begin(); it != m_vecMessages.end(); ++it) {
+                const message_ptr& cand = *it;
+                if (m_aBandOf[cand->get_priority()] != band) continue;
+                if (cand->is_marked() || cand->is_pending()) continue;
+                if (victim == m_vecMessages.end() || cand->get_priority() > (*victim)->get_priority() ||
+                    (cand->get_priority() == (*victim)->get_priority() && cand->get_timestamp() < (*victim)->get_timestamp()))
+                    victim = it;
+            }
+        }
+        if (victim == m_vecMessages.end() || (*victim)->get_priority() < msg->get_priority())
+            return post_result::capacity;
+
+        message_ptr evicted = *victim;
+        m_vecMessages.remove(victim);
+        trackMessage(evicted->get_priority(), -1);
+        unindexMessage(evicted);
+        if (m_pJournal != nullptr)
+            m_pJournal->appendTombstone(*evicted);
+        evicted->set_postresult(post_result::evicted);
+        SES_TRACE_EVENT(evict, evicted);
+        m_vecNotices.push_back(post_notice{ evicted, post_notice::discard, false });
+        m_vecGarbage.push_back(std::move(evicted));
+        return post_result::added;
+    }
+
+    void eventmanager::trackMessage(uint8_t prio, int delta) {
+        // Nur exklusiv (postMessage oder einziger Halter in endProcessMessages), das Bit folgt dem neuen Stand statt ihn umzuschalten.
+        // Eine neue Nachricht ist immer bereit, auch wenn die Priorität nur laufende asynchrone Nachrichten enthielt.
+        const uint64_t bit = 1ull << (prio & 63);
+        m_aPrioCount[prio] += delta;
+        if (delta > 0 && (m_aPrioMask[prio >> 6].load(std::memory_order_relaxed) & bit) == 0)
+            m_aPrioMask[prio >> 6].fetch_or(bit, std::memory_order_release);
+        else if (m_aPrioCount[prio] == 0)
+            m_aPrioMask[prio >> 6].fetch_and(~bit, std::memory_order_release);
+        m_ulCount += delta;
+        m_bSnapshotDirty.store(true, std::memory_order_relaxed);
+        int band = m_aBandOf[prio];
+        if (band >= 0) m_vecBands[band].count += delta;
+    }
+
+    void eventmanager::notifyArrival(uint8_t prio) {
+        // Die Maske ist gesetzt, bevor der Wartezähler gelesen wird; wait_for_messages erhöht ihn, bevor es die Maske prüft
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_uiWaiters.load() > 0) {
+            const std::lock_guard<std::mutex> lock(m_mtxWait);
+            m_cvWait.notify_all();
+        }
+        for (auto& sub : m_vecSubscriptions) {
+            if (prio < sub->m_ucFrom || prio > sub->m_ucTo) continue;
+            // Nur der erste Treffer seit acknowledge signalisiert, ein Schub Nachrichten weckt den Reaktor einmal
+            if (!sub->m_bSignaled.load(std::memory_order_relaxed) && !sub->m_bSignaled.exchange(true))
+                sub->m_event.signal();
+        }
+    }
+
+    bool eventmanager::wait_for_messages(int from, int to, uint64_t timeoutMs) {
+        if (get_top_priority(from, to) >= 0) return true;
+
+        uint32_t spins = m_uiSpin.load(std::memory_order_relaxed);
+        for (uint32_t i = 0; i < spins; i++) {
+            tool::cpu_relax();
+            if (get_top_priority(from, to) >= 0) {
+                m_uiSpin.store(std::min(spins * 2, WAIT_SPIN_MAX), std::memory_order_relaxed);
+                return true;
+            }
+        }
+        m_uiSpin.store(std::max(spins / 2, WAIT_SPIN_MIN), std::memory_order_relaxed);
+
+        std::unique_lock<std::mutex> lock(m_mtxWait);
+        m_uiWaiters++;
+        // Gegenstück zum Zaun in notifyArrival: der Zähler ist sichtbar, bevor die Maske gelesen wird
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto ready = [this, from, to] { return get_top_priority(from, to) >= 0; };
+        bool result = true;
+        if (timeoutMs == TIMEDLOCK_INFINITY_WAIT)
+            m_cvWait.wait(lock, ready);
+        else
+            result = m_cvWait.wait_for(lock, std::chrono::milliseconds(timeoutMs), ready);
+        m_uiWaiters--;
+        return result;
+    }
+
+    eventmanager::subscription_ptr eventmanager::subscribe(uint8_t from, uint8_t to) {
+        subscription_ptr sub(new subscription(from, to));
+        if (!sub->m_event.is_valid()) return nullptr;
+
+        if (m_ctLock.try_lock(TIMEDLOCK_INFINITY_WAIT)) {
+            m_vecSubscriptions.push_back(sub);
+            m_ctLock.release();
+        }
+        // Bereits wartende Nachrichten sofort melden
+        acknowledge(sub);
+        return sub;
+    }
+
+    void eventmanager::acknowledge(const subscription_ptr& sub) {
+        if (sub == nullptr) return;
+        sub->m_event.reset();
+        sub->m_bSignaled.store(false);
+        // Zwischen reset und store gepostete Nachrichten haben kein Signal ausgelöst, daher die Maske erneut prüfen
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (get_top_priority(sub->m_ucFrom, sub->m_ucTo) >= 0 && !sub->m_bSignaled.exchange(true))
+            sub->m_event.signal();
+    }
+
+    void eventmanager::unsubscribe(const subscription_ptr& sub) {
+        if (m_ctLock.try_lock(TIMEDLOCK_INFINITY_WAIT)) {
+            m_vecSubscriptions.erase(std::remove(m_vecSubscriptions.begin(), m_vecSubscriptions.end(), sub), m_vecSubscriptions.end());
+            m_ctLock.release();
+        }
+    }
+
+    void eventmanager::unindexMessage(const message_ptr& msg) {
+        if (msg->get_coalescekey() == 0) return;
+
+        auto entry = m_mapCoalesce.find(msg->get_coalescekey());
+        if (entry != m_mapCoalesce.end() && entry->second == msg)
+            m_mapCoalesce.erase(entry);
+    }
+
+    void eventmanager::set_capacity(uint8_t from, uint8_t to, size_t capacity, shed_policy policy) {
+        if (m_ctLock.try_lock(TIMEDLOCK_INFINITY_WAIT)) {
+            capacity_band band = { from, to, capacity, policy, 0 };
+            int16_t index = static_cast<int16_t>(m_vecBands.size());
+            m_vecBands.push_back(band);
+
+            for (int prio = from; prio <= to; prio++)
+                m_aBandOf[prio] = index;
+            // Zähler aller Bänder neu aufbauen, da überlappende Bänder Prioritäten abgeben
+            for (auto& entry : m_vecBands) entry.count = 0;
+            for (int prio = 0; prio < 256; prio++) {
+                if (m_aBandOf[prio] >= 0) m_vecBands[m_aBandOf[prio]].count += m_aPrioCount[prio];
+            }
+            m_ctLock.release();
+        }
+    }
+
+    void eventmanager::clear_capacity() {
+        if (m_ctLock.try_lock(TIMEDLOCK_INFINITY_WAIT)) {
+            m_vecBands.clear();
+            std::fill(std::begin(m_aBandOf), std::end(m_aBandOf), -1);
+            m_ctLock.release();
+        }
+    }
+
+    void eventmanager::set_order_policy(order_policy policy) {
+        if (m_ctLock.try_lock(TIMEDLOCK_INFINITY_WAIT)) {
+            switch (policy) {
+            case order_policy::deadline:
+                m_funcOrder = compare_deadline;
+                m_vecMessages.set_key(key_deadline, 64);
+                break;
+            case order_policy::priority_deadline:
+                m_funcOrder = compare_priority_deadline;
+                m_vecMessages.set_key(key_priority_deadline, 64);
+                break;
+            default:
+                m_funcOrder = compare_message;
+                m_vecMessages.set_key(key_priority, 8);
+                break;
+            }
+            m_eOrder = policy;
+            m_vecMessages.set_handle(m_funcOrder);
+            m_ctLock.release();
+        }
+    }
+
+    void eventmanager::set_reclaimer(reclaimer* pReclaimer) {
+        if (m_ctLock.try_lock(TIMEDLOCK_INFINITY_WAIT)) {
+            m_pReclaimer = pReclaimer;
+            m_ctLock.release();
         }
     }
 
+    void eventmanager::set_recorder(recorder* pRecorder) {
+        if (m_ctLock.try_lock(TIMEDLOCK_INFINITY_WAIT)) {
+            m_pRecorder = pRecorder;
+            m_ctLock.release();
+        }
+    }
+
+    void eventmanager::set_statistics(bool enabled) {
+        m_bStatistics.store(enabled);
+    }
+
+    void eventmanager::get_statistics(priority_stats& stats) const {
+        for (int prio = 0; prio < 256; prio++) {
+            stats.arrivals[prio] = m_aArrivals[prio].load(std::memory_order_relaxed);
+            stats.processed[prio] = m_aProcessed[prio].load(std::memory_order_relaxed);
+            stats.cost_ns[prio] = m_aCostNs[prio].load(std::memory_order_relaxed);
+        }
+    }
+
+    uint64_t eventmanager::handlerStart() const {
+        return (m_pRecorder != nullptr || m_bStatistics.load(std::memory_order_relaxed)) ? recorder::clock_ns() : 0;
+    }
+
+    void eventmanager::accountPost(const message& msg) {
+        if (m_pRecorder != nullptr)
+            m_pRecorder->recordPost(msg);
+        if (m_bStatistics.load(std::memory_order_relaxed))
+            m_aArrivals[msg.get_priority()].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    uint64_t eventmanager::handlerCost(uint64_t start) const {
+        return (start != 0) ? recorder::clock_ns() - start : 0;
+    }
+
+    void eventmanager::accountHandler(const message& msg, bool success, uint64_t cost) {
+        if (m_pRecorder != nullptr)
+            m_pRecorder->recordOutcome(msg, success, cost);
+        if (m_bStatistics.load(std::memory_order_relaxed)) {
+            m_aProcessed[msg.get_priority()].fetch_add(1, std::memory_order_relaxed);
+            m_aCostNs[msg.get_priority()].fetch_add(cost, std::memory_order_relaxed);
+        }
+    }
+
+    void eventmanager::retireMessages(std::vector<message_ptr>& garbage) {
+        // Ohne reclaimer zerstört der Aufrufer die Nachrichten beim Verlassen seines Gültigkeitsbereichs
+        if (m_pReclaimer != nullptr && !garbage.empty())
+            m_pReclaimer->retire(garbage);
+    }
+
+    void eventmanager::set_journal(journal* pJournal) {
+        if (m_ctLock.try_lock(TIMEDLOCK_INFINITY_WAIT)) {
+            m_pJournal = pJournal;
+            m_ctLock.release();
+        }
+    }
+
+    size_t eventmanager::restoreMessages() {
+        if (m_pJournal == nullptr) return 0;
+
+        std::vector<message_ptr> restored = m_pJournal->replay();
+        for (auto& msg : restored)
+            postMessage(msg, TIMEDLOCK_INFINITY_WAIT);
+        // Alte Segmente erst löschen, wenn die Nachrichten neu aufgezeichnet sind
+        m_pJournal->commit();
+        m_pJournal->drop_replayed();
+        return restored.size();
+    }
+
     void eventmanager::clearMessages() {
+        // Vor dem Lock widerrufen: ein Abschluss hält die Verbindung und wartet unter Umständen auf den Lock
+        m_ptrAsync->revoke();
         if (m_ctLock.try_lock(TIMEDLOCK_INFINITY_WAIT)) {
+            m_ptrAsync = std::make_shared<async_link>(this);
+            if (m_pJournal != nullptr) {
+                for (auto& msg : m_vecMessages) m_pJournal->appendTombstone(*msg);
+            }
+            std::vector<message_ptr> garbage;
+            garbage.reserve(m_vecMessages.size());
+            for (auto& msg : m_vecMessages) {
+                SES_TRACE_EVENT(remove, msg);
+                garbage.push_back(std::move(msg));
+            }
             m_vecMessages.clear();
             m_vecDiscards.clear();
+            m_mapCoalesce.clear();
+            std::fill(std::begin(m_aPrioCount), std::end(m_aPrioCount), 0);
+            for (auto& mask : m_aPrioMask) mask.store(0);
+            for (auto& band : m_vecBands) band.count = 0;
+            m_ulCount = 0;
+            std::shared_ptr<queue_snapshot> snapshot = collectSnapshot(true);
+            {
+                const std::lock_guard<std::mutex> lock(m_mtxCompleted);
+                m_vecCompleted.clear();
+            }
             m_ctLock.release();  // Lock wieder freigeben!
+            publishSnapshot(std::move(snapshot));
+            commitJournal(true);
+            retireMessages(garbage);
+        }
+    }
+
+    void eventmanager::registerBatchHandler(uint32_t typeTag, batch_func func, size_t maxBatch, uint64_t maxLingerMs) {
+        if (m_ctLock.try_lock(TIMEDLOCK_INFINITY_WAIT)) {
+            m_mapBatches[typeTag] = batch_handler{ std::move(func), (maxBatch == 0) ? 1 : maxBatch, maxLingerMs };
+            m_ctLock.release();
+        }
+    }
+
+    void eventmanager::unregisterBatchHandler(uint32_t typeTag) {
+        if (m_ctLock.try_lock(TIMEDLOCK_INFINITY_WAIT)) {
+            m_mapBatches.erase(typeTag);
+            m_ctLock.release();
+        }
+    }
+
+    void eventmanager::registerHandler(uint32_t typeTag, handler_func func) {
+        if (m_ctLock.try_lock(TIMEDLOCK_INFINITY_WAIT)) {
+            m_mapHandlers[typeTag] = func;
+            m_ctLock.release();
+        }
+    }
+
+    void eventmanager::unregisterHandler(uint32_t typeTag) {
+        if (m_ctLock.try_lock(TIMEDLOCK_INFINITY_WAIT)) {
+            m_mapHandlers.erase(typeTag);
+            m_ctLock.release();
         }
     }
 
     size_t eventmanager::get_messages() const {
-        return m_vecMessages.size();
+        return m_ulCount.load();
+    }
+
+    int eventmanager::get_top_priority(int from, int to) const {
+        from = std::max(from, 0);
+        to = std::min(to, 255);
+        for (int word = from >> 6; word <= (to >> 6) && from <= to; word++) {
+            uint64_t bits = m_aPrioMask[word].load(std::memory_order_acquire);
+            if (word == (from >> 6)) bits &= ~0ull << (from & 63);
+            if (word == (to >> 6) && (to & 63) != 63) bits &= (1ull << ((to & 63) + 1)) - 1;
+            if (bits == 0) continue;
+            int prio = word << 6;
+            while ((bits & 1) == 0) {
+                bits >>= 1;
+                prio++;
+            }
+            return prio;
+        }
+        return -1;
     }
 
     eventmanager::message_ptr eventmanager::get_byID(id_type id, uint64_t maxTime) {
         if (m_ctLock.try_lock(maxTime)) {
             auto it = std::find_if(m_vecMessages.begin(), m_vecMessages.end(),
                 [id](const message_ptr& msg) { return msg->get_id().full == id.full; });
-            return (it != m_vecMessages.end()) ? *it : nullptr;
+            message_ptr result = (it != m_vecMessages.end()) ? *it : nullptr;
+            m_ctLock.release();
+            return result;
         }
         return nullptr;
     }
 
+    std::shared_ptr<const queue_snapshot> eventmanager::get_snapshot() const {
+        // Eine Änderung innerhalb des Intervalls, nach der die Warteschlange ruht, holt der nächste Leser nach
+        if (m_bSnapshotDirty.load(std::memory_order_relaxed) && tool::now() - m_ulSnapshotTime.load() >= m_ulSnapshotInterval)
+            const_cast<eventmanager*>(this)->refreshSnapshot();
+        return std::atomic_load(&m_ptrSnapshot);
+    }
+
+    void eventmanager::refreshSnapshot() {
+        // Umgeordnet wird nur exklusiv, zum Kopieren genügt daher ein geteilter Halter
+        m_ctLock.add();
+        std::shared_ptr<queue_snapshot> snapshot = collectSnapshot(false);
+        m_ctLock.release();
+        publishSnapshot(std::move(snapshot));
+    }
+
+    std::shared_ptr<queue_snapshot> eventmanager::collectSnapshot(bool force) {
+        // Nur nach einer Änderung und höchstens alle m_ulSnapshotInterval ms kopieren, sonst zahlt jeder Zyklus für die Überwachung
+        uint64_t now = tool::now();
+        if (!force && (now - m_ulSnapshotTime.load() < m_ulSnapshotInterval || !m_bSnapshotDirty.load()))
+            return nullptr;
+        if (!m_bSnapshotDirty.exchange(false) && !force)
+            return nullptr; // Ein anderer Verarbeiter kopiert bereits
+        m_ulSnapshotTime.store(now);
+
+        std::shared_ptr<queue_snapshot> snapshot = std::make_shared<queue_snapshot>();
+        snapshot->m_ulVersion = ++m_ulSnapshotVersion;
+        snapshot->m_ulTime = now;
+        snapshot->m_vecEntries.reserve(m_vecMessages.size());
+
+        for (const message_ptr& msg : m_vecMessages) {
+            snapshot_entry entry;
+            entry.id = msg->get_id().full;
+            entry.typetag = msg->get_typetag();
+            entry.timestamp = msg->get_timestamp();
+            entry.alivems = msg->get_alivems();
+            entry.priority = msg->get_priority();
+            entry.discards = static_cast<uint8_t>(msg->get_discards());
+            entry.marked = msg->is_marked();
+            entry.pending = msg->is_pending();
+            snapshot->m_vecEntries.push_back(entry);
+            snapshot->m_aCount[entry.priority]++;
+        }
+        return snapshot;
+    }
+
+    void eventmanager::publishSnapshot(std::shared_ptr<queue_snapshot> snapshot) {
+        if (snapshot == nullptr) return;
+
+        // Der ID-Index entsteht erst nach dem Freigeben des Locks
+        snapshot->m_vecById.resize(snapshot->m_vecEntries.size());
+        for (uint32_t i = 0; i < snapshot->m_vecById.size(); i++) snapshot->m_vecById[i] = i;
+        std::sort(snapshot->m_vecById.begin(), snapshot->m_vecById.end(),
+            [&snapshot](uint32_t a, uint32_t b) { return snapshot->m_vecEntries[a].id < snapshot->m_vecEntries[b].id; });
+
+        // Gleichzeitig fertig gewordene ältere Schnappschüsse dürfen einen neueren nicht ersetzen
+        const std::lock_guard<std::mutex> lock(m_mtxSnapshot);
+        if (std::atomic_load(&m_ptrSnapshot)->m_ulVersion < snapshot->m_ulVersion)
+            std::atomic_store(&m_ptrSnapshot, std::shared_ptr<const queue_snapshot>(std::move(snapshot)));
+    }
+
+    void eventmanager::commitJournal(bool force) {
+        // Außerhalb von m_ctLock: das Journal sichert unter seinem eigenen Lock, Poster und Worker warten nicht auf das Medium
+        if (m_pJournal != nullptr && (force || m_pJournal->is_commit_due()))
+            m_pJournal->commit();
+    }
+
     bool eventmanager::beginMessages() {
         m_ctLock.add();
         size_t size = m_vecMessages.size();
@@ -58,46 +797,298 @@ namespace ses {
         
     }
     bool eventmanager::endProcessMessages() {
-        for (auto it = m_vecMessages.begin(); it != m_vecMessages.end(); )
-        {
-            message_ptr& msg = *it;
-            if (msg->is_marked() == true)
-                it = m_vecMessages.remove(it);
-            else
-                ++it;
+        std::vector<message_ptr> garbage;
+        std::vector<post_notice> notices;
+        drainCompleted();
+        if (!t_vecLocalPosts.empty())
+            mergeLocalPosts(garbage);
+
+        // Entfernen und Einreihen nur als einziger Halter: andere Worker iterieren sonst über die Warteschlange, die dabei schrumpfen,
+        // wachsen oder sich umordnen würde. Andernfalls übernimmt das der letzte Worker oder das nächste exklusive postMessage.
+        if (m_ctLock.try_upgrade()) {
+            m_bSweep.store(false, std::memory_order_relaxed);
+            sweepMessages();
+            if (m_bHandoff.load(std::memory_order_acquire)) insertHandoff();
+            for (auto& msg : m_vecGarbage) garbage.push_back(std::move(msg));
+            m_vecGarbage.clear();
+            notices.swap(m_vecNotices);
+            m_ctLock.downgrade();
         }
-        m_ctLock.release();
+        else
+            m_bSweep.store(true, std::memory_order_release);
+        std::shared_ptr<queue_snapshot> snapshot = collectSnapshot(false);
+        bool last = m_ctLock.release();
+#ifdef SES_USE_SKIPLIST
+        // Ausgehängte Knoten freigeben, sobald kein Verarbeiter mehr iteriert
+        if (last)
+            m_vecMessages.collect();
+#endif
+        publishSnapshot(std::move(snapshot));
+        commitJournal(false);
+        deliverNotices(notices);
+        retireMessages(garbage);
+        // Waren alle Worker gleichzeitig fertig, war keiner einziger Halter: der letzte holt das Aufräumen nach, bevor Wartende
+        // wegen erledigter Nachrichten in der Maske erneut geweckt werden
+        if (last && (m_bSweep.load(std::memory_order_acquire) || m_bHandoff.load(std::memory_order_acquire)))
+            tidyMessages();
 
         std::cout << "messgae size: " << m_vecMessages.size() << " locks: " << m_ctLock.get_locks() << " \n";
         
         return true;
     }
     bool eventmanager::processMessages(int from, int to) {
+        return runMessages(from, to, nullptr, 0, 0);
+    }
+
+    bool eventmanager::processMessages(int from, int to, process_cursor& cursor, size_t maxMessages, uint64_t maxMicros) {
+        return runMessages(from, to, &cursor, maxMessages, maxMicros);
+    }
+
+    bool eventmanager::runMessages(int from, int to, process_cursor* cursor, size_t maxMessages, uint64_t maxMicros) {
         if (m_ctLock.get_locks() == 0) return false;
         uint64_t now = tool::now();
+        batch_map batches;
+        dispatch_list table;
+        processing_scope scope(this);
+
+        drainCompleted();
+
+        // Außer unter deadline ist die Warteschlange nach Priorität geordnet: direkt zum Bereichsanfang springen und hinter dem
+        // Bereich abbrechen. Abgelaufene Nachrichten außerhalb des Bereichs entfernt dann endProcessMessages.
+        const bool ranged = m_eOrder != order_policy::deadline;
+        auto it = (ranged && from > 0 && from <= 255) ? m_vecMessages.lower_bound(first_of_priority(static_cast<uint8_t>(from))) : m_vecMessages.begin();
+        uint64_t deadline = 0;
+        size_t handled = 0;
+        bool stopped = false;
+        if (cursor != nullptr) {
+            if (maxMicros > 0) deadline = clock_us() + maxMicros;
+            if (cursor->last != nullptr) {
+                // Hinter der zuletzt bearbeiteten Nachricht fortsetzen, ist sie bereits entfernt, an ihrer Stelle in der Ordnung
+                it = m_vecMessages.find(cursor->last);
+                if (it != m_vecMessages.end())
+                    ++it;
+                else
+                    it = m_vecMessages.lower_bound(cursor->last);
+            }
+        }
 
-        for (auto it = m_vecMessages.begin(); it != m_vecMessages.end(); it++ ) {
+        for (; it != m_vecMessages.end(); ++it) {
             message_ptr& msg = *it;
             if (msg == 0) continue;
+            if (ranged && msg->get_priority() > to) break;
+            if (msg->is_pending()) continue;
+
+            bool expired = msg->is_expired(now);
+            int prio = msg->get_priority();
+            if (!expired && (prio < from || prio > to || msg->is_marked())) continue;
 
-            if (msg->is_expired(now)) {
+            if (cursor != nullptr) {
+                if ((maxMessages > 0 && handled >= maxMessages) || (deadline > 0 && clock_us() >= deadline)) {
+                    stopped = true;
+                    break;
+                }
+                cursor->last = msg;
+                handled++;
+            }
+
+            if (expired) {
+                SES_TRACE_EVENT(expire, msg);
                 msg->onMessageExpired(this, now);
                 msg->set_runned();
+                continue;
+            }
+            if (!m_mapBatches.empty() && m_mapBatches.count(msg->get_typetag()) > 0) {
+                batches[msg->get_typetag()].push_back(msg);
+                continue;
             }
-            else {
-                int prio = msg->get_priority();
-                if (prio >= from && prio <= to && msg->is_marked() == false) {
-                 
-                    if (msg->onMessageProcess(this))
-                        msg->set_runned();
-                    else
-                        discardMessage(msg);
+            if (!m_mapHandlers.empty()) {
+                auto hit = m_mapHandlers.find(msg->get_typetag());
+                if (hit != m_mapHandlers.end()) {
+                    table.emplace_back(hit->second, msg);
+                    continue;
                 }
             }
+            if (msg->is_async()) {
+                SES_TRACE_EVENT(handler_begin, msg);
+                msg->set_flag(message::flag_pending, true);
+                static_cast<async_message*>(msg.get())->onMessageProcessAsync(this, async_token(m_ptrAsync, msg));
+                continue;
+            }
+            SES_TRACE_EVENT(handler_begin, msg);
+            uint64_t start = handlerStart();
+            bool success = msg->onMessageProcess(this);
+            accountHandler(*msg, success, handlerCost(start));
+            SES_TRACE_EVENT(handler_end, msg);
+            if (success)
+                msg->set_runned();
+            else
+                discardMessage(msg);
+        }
+        if (cursor != nullptr) {
+            cursor->processed = handled;
+            cursor->complete = !stopped;
+            if (!stopped) cursor->last = nullptr;
         }
+        if (!table.empty())
+            dispatchTable(table);
+        if (!batches.empty())
+            flushBatches(batches, now);
+        if (m_ulChainLimit > 0 && !t_vecLocalPosts.empty())
+            runChained(from, to);
         return true;
     }
 
+    void eventmanager::runChained(int from, int to) {
+        size_t chained = 0;
+        // Über den Index, da verarbeitete Nachrichten weitere Folge-Nachrichten anhängen können
+        for (size_t i = 0; i < t_vecLocalPosts.size() && chained < m_ulChainLimit; i++) {
+            if (t_vecLocalPosts[i].owner != this) continue;
+            message_ptr msg = t_vecLocalPosts[i].msg;
+            int prio = msg->get_priority();
+            // Zusammenfassbare, asynchrone und blockweise verarbeitete Nachrichten brauchen die Warteschlange
+            if (prio < from || prio > to || msg->is_marked() || msg->is_async() || msg->get_coalescekey() != 0) continue;
+            if (!m_mapBatches.empty() && m_mapBatches.count(msg->get_typetag()) > 0) continue;
+            // Zulassung vor der Ausführung: in einem vollen (bzw. unter early_drop halb vollen) Band entscheidet admitMessage beim Einreihen
+            int band = m_aBandOf[prio];
+            if (band >= 0) {
+                const capacity_band& entry = m_vecBands[band];
+                size_t limit = (entry.policy == shed_policy::early_drop) ? entry.capacity / 2 : entry.capacity;
+                if (entry.count >= limit) continue;
+            }
+
+            chained++;
+            msg->set_postresult(post_result::added);
+            SES_TRACE_EVENT(post, msg);
+            accountPost(*msg);
+            msg->onMessagePost(this, true);
+            bool success;
+            SES_TRACE_EVENT(handler_begin, msg);
+            uint64_t start = handlerStart();
+            auto hit = m_mapHandlers.find(msg->get_typetag());
+            if (hit != m_mapHandlers.end())
+                success = hit->second(this, forward_message::payload_of(*msg));
+            else
+                success = msg->onMessageProcess(this);
+            accountHandler(*msg, success, handlerCost(start));
+            SES_TRACE_EVENT(handler_end, msg);
+            if (success)
+                msg->set_runned();
+            else
+                discardMessage(msg);
+        }
+    }
+
+    void eventmanager::dispatchTable(dispatch_list& list) {
+        // Nach Handler gruppieren, innerhalb einer Gruppe bleibt die Prioritätsreihenfolge erhalten
+        std::stable_sort(list.begin(), list.end(),
+            [](const dispatch_list::value_type& a, const dispatch_list::value_type& b) {
+                return a.second->get_typetag() < b.second->get_typetag();
+            });
+
+        for (auto& entry : list) {
+            SES_TRACE_EVENT(handler_begin, entry.second);
+            uint64_t start = handlerStart();
+            bool success = entry.first(this, forward_message::payload_of(*entry.second));
+            accountHandler(*entry.second, success, handlerCost(start));
+            SES_TRACE_EVENT(handler_end, entry.second);
+            if (success)
+                entry.second->set_runned();
+            else
+                discardMessage(entry.second);
+        }
+    }
+
+    void eventmanager::flushBatches(batch_map& batches, uint64_t now) {
+        for (auto& entry : batches) {
+            const batch_handler& handler = m_mapBatches[entry.first];
+            std::vector<message_ptr>& msgs = entry.second;
+
+            for (size_t pos = 0; pos < msgs.size(); pos += handler.maxBatch) {
+                size_t count = std::min(handler.maxBatch, msgs.size() - pos);
+
+                // Unvollständige Blöcke warten, bis die älteste Nachricht die Linger-Zeit erreicht hat
+                if (count < handler.maxBatch) {
+                    uint64_t oldest = now;
+                    for (size_t i = pos; i < pos + count; i++)
+                        oldest = std::min(oldest, msgs[i]->get_timestamp());
+                    if (now - oldest < handler.maxLingerMs) break;
+                }
+
+#ifdef SES_TRACE
+                for (size_t i = pos; i < pos + count; i++) SES_TRACE_EVENT(handler_begin, msgs[i]);
+#endif
+                // Weitergeleitete Kopien eines eventbus erhalten die Handler als eigentliche Nachricht
+                std::vector<message_ptr> payloads;
+                if (std::any_of(msgs.begin() + pos, msgs.begin() + pos + count, [](const message_ptr& m) { return m->is_forward(); })) {
+                    for (size_t i = pos; i < pos + count; i++) payloads.push_back(forward_message::payload_of(msgs[i]));
+                }
+                uint64_t start = handlerStart();
+                bool success = handler.func(this, payloads.empty() ? &msgs[pos] : payloads.data(), count);
+                if (start != 0) {
+                    // Die Dauer des Blocks wird gleichmäßig auf seine Nachrichten verteilt
+                    uint64_t share = handlerCost(start) / count;
+                    for (size_t i = pos; i < pos + count; i++)
+                        accountHandler(*msgs[i], success, share);
+                }
+#ifdef SES_TRACE
+                for (size_t i = pos; i < pos + count; i++) SES_TRACE_EVENT(handler_end, msgs[i]);
+#endif
+                if (success) {
+                    for (size_t i = pos; i < pos + count; i++)
+                        msgs[i]->set_runned();
+                }
+                else {
+                    for (size_t i = pos; i < pos + count; i++)
+                        discardMessage(msgs[i]);
+                }
+            }
+        }
+    }
+
+    void eventmanager::completeMessage(const message_ptr& msg, bool success) {
+        uint8_t prio = msg->get_priority();
+        {
+            const std::lock_guard<std::mutex> lock(m_mtxCompleted);
+            m_vecCompleted.emplace_back(msg, success);
+            // Der Abschluss macht die Priorität wieder bereit, damit ein Worker ihn abholt
+            m_aPrioMask[prio >> 6].fetch_or(1ull << (prio & 63), std::memory_order_release);
+        }
+        // Die Abonnements ändern sich nur unter exklusivem Lock
+        m_ctLock.add();
+        notifyArrival(prio);
+        m_ctLock.release();
+    }
+
+    void eventmanager::drainCompleted() {
+        std::vector<std::pair<message_ptr, bool>> completed;
+        {
+            const std::lock_guard<std::mutex> lock(m_mtxCompleted);
+            if (m_vecCompleted.empty()) return;
+            completed.swap(m_vecCompleted);
+        }
+
+        for (auto& entry : completed) {
+            SES_TRACE_EVENT(handler_end, entry.first);
+            accountHandler(*entry.first, entry.second, 0);
+            entry.first->set_flag(message::flag_pending, false);
+            if (entry.second)
+                entry.first->set_runned();
+            else
+                discardMessage(entry.first);
+        }
+    }
+
+    void async_token::complete(bool success) {
+        if (m_ptrState == nullptr || m_ptrState->done.exchange(true)) return;
+        m_ptrState->link->complete(m_ptrState->msg, success);
+    }
+
+    void async_link::complete(const std::shared_ptr<message>& msg, bool success) {
+        const std::lock_guard<std::mutex> lock(m_mtx);
+        if (m_pManager != nullptr)
+            m_pManager->completeMessage(msg, success);
+    }
+
     bool eventmanager::processMessages(uint8_t prio) {
         return processMessages(prio, prio);
     }
@@ -105,9 +1096,11 @@ namespace ses {
     void eventmanager::discardMessage(const message_ptr& msg) {
 
         msg->set_discard();
+        SES_TRACE_EVENT(discard, msg);
         if (msg->get_discards() >= 5) {
+            // Entfernt wird erst in endProcessMessages, damit laufende Iterationen gültig bleiben
             m_vecDiscards.push_back(msg);
-            m_vecMessages.remove(msg);
+            msg->set_runned();
 
             msg->onMessageDiscard(this, tool::now());
         }
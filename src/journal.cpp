@@ -0,0 +1,415 @@
+// SPDX-License-Identifier: EUPL-1.2
+
+#include "journal.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ses {
+    static const uint32_t JOURNAL_MAGIC = 0x4A534553; // "SESJ"
+    static const uint32_t JOURNAL_VERSION = 2;
+    static const size_t   JOURNAL_HEADER = 32;
+
+    static const uint8_t RECORD_POST = 1;
+    static const uint8_t RECORD_TOMBSTONE = 2;
+
+#pragma pack(push, 1)
+    struct segment_header {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t sequence;
+        uint8_t  reserved[16];
+    };
+
+    struct record_header {
+        uint32_t size;      // Länge der Nutzdaten
+        uint32_t checksum;  // FNV-1a über Kopf (checksum = 0) und Nutzdaten
+        uint8_t  kind;
+        uint8_t  priority;
+        uint16_t reserved;
+        uint32_t id;
+        uint64_t record;    // Satznummer, eindeutig im Journal über Neustarts hinweg; Grabsteine tragen die des Postsatzes
+        uint64_t timestamp; // Wanduhrzeit des Sendens in Millisekunden
+        uint32_t alivems;
+        uint32_t typetag;
+    };
+#pragma pack(pop)
+
+    static size_t record_length(uint32_t size) {
+        return (sizeof(record_header) + size + 7) & ~size_t(7);
+    }
+
+    static uint32_t checksum(const record_header& header, const uint8_t* payload) {
+        record_header copy = header;
+        copy.checksum = 0;
+
+        uint32_t hash = 2166136261u;
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&copy);
+        for (size_t i = 0; i < sizeof(copy); i++) hash = (hash ^ bytes[i]) * 16777619u;
+        for (size_t i = 0; i < header.size; i++) hash = (hash ^ payload[i]) * 16777619u;
+        return hash;
+    }
+
+    static void sync_range(uint8_t* data, intptr_t file, size_t from, size_t to) {
+#ifdef _WIN32
+        FlushViewOfFile(data + from, to - from);
+        FlushFileBuffers(reinterpret_cast<HANDLE>(file));
+#else
+        (void)file;
+        size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        size_t start = from & ~(page - 1);
+        msync(data + start, to - start, MS_SYNC);
+#endif
+    }
+
+    static uint64_t wall_now() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    journal::journal(const std::string& directory, size_t segmentSize, size_t groupCommit)
+        : m_strDirectory(directory), m_ulSegmentSize(std::max<size_t>(segmentSize, 4096)), m_ulGroupCommit(std::max<size_t>(groupCommit, 1)),
+          m_ulNextSequence(0), m_ulNextRecord(0), m_ulWriteOffset(0), m_ulFlushOffset(0), m_ulUncommitted(0), m_ulCommitInterval(10), m_ulFirstUncommitted(0),
+          m_bCommitting(false)
+    {
+#ifdef _WIN32
+        CreateDirectoryA(m_strDirectory.c_str(), NULL);
+#else
+        mkdir(m_strDirectory.c_str(), 0755);
+#endif
+        std::vector<uint64_t> existing = listSegments();
+        if (!existing.empty())
+            m_ulNextSequence = existing.back() + 1;
+    }
+
+    journal::~journal() {
+        const std::lock_guard<std::mutex> lock(m_mtxJournal);
+        flush();
+        for (auto& seg : m_vecSegments)
+            closeSegment(seg, false);
+        m_vecSegments.clear();
+    }
+
+    void journal::register_type(uint32_t typeTag, factory_func func) {
+        const std::lock_guard<std::mutex> lock(m_mtxJournal);
+        m_mapFactories[typeTag] = std::move(func);
+    }
+
+    bool journal::appendPost(const message& msg) {
+        std::vector<uint8_t> payload;
+        if (!msg.serialize(payload)) return false;
+
+        const std::lock_guard<std::mutex> lock(m_mtxJournal);
+        if (!appendRecord(RECORD_POST, msg, payload.data(), static_cast<uint32_t>(payload.size())))
+            return false;
+
+        segment& current = m_vecSegments.back();
+        current.live++;
+        m_mapLive[&msg] = live_record{ m_ulNextRecord - 1, current.sequence };
+        return true;
+    }
+
+    void journal::appendTombstone(const message& msg) {
+        const std::lock_guard<std::mutex> lock(m_mtxJournal);
+        auto entry = m_mapLive.find(&msg);
+        if (entry == m_mapLive.end()) return;
+
+        live_record live = entry->second;
+        m_mapLive.erase(entry);
+
+        record_header header = {};
+        header.kind = RECORD_TOMBSTONE;
+        header.id = msg.get_id().full;
+        header.record = live.record;
+        header.checksum = checksum(header, nullptr);
+        size_t length = record_length(0);
+        if (m_vecSegments.empty() || m_ulWriteOffset + length > m_ulSegmentSize) {
+            flush();
+            if (!openSegment()) return;
+        }
+        std::memcpy(m_vecSegments.back().data + m_ulWriteOffset, &header, sizeof(header));
+        m_ulWriteOffset += length;
+        if (m_ulUncommitted++ == 0) m_ulFirstUncommitted = tool::now();
+
+        for (auto& seg : m_vecSegments) {
+            if (seg.sequence == live.sequence) {
+                seg.live--;
+                break;
+            }
+        }
+        trimSegments();
+    }
+
+    void journal::commit() {
+        const std::lock_guard<std::mutex> commitLock(m_mtxCommit);
+        uint8_t* data;
+        intptr_t file;
+        size_t from, to;
+        {
+            const std::lock_guard<std::mutex> lock(m_mtxJournal);
+            if (m_vecSegments.empty() || m_ulFlushOffset == m_ulWriteOffset) return;
+            segment& current = m_vecSegments.back();
+            data = current.data;
+            file = current.file;
+            from = m_ulFlushOffset;
+            to = m_ulWriteOffset;
+            m_ulUncommitted = 0;
+            m_bCommitting = true;
+        }
+
+        sync_range(data, file, from, to);
+
+        const std::lock_guard<std::mutex> lock(m_mtxJournal);
+        m_bCommitting = false;
+        // Wurde inzwischen ein neues Segment begonnen, hat appendRecord das alte bereits gesichert
+        if (m_vecSegments.back().data == data)
+            m_ulFlushOffset = std::max(m_ulFlushOffset, to);
+        trimSegments();
+    }
+
+    bool journal::is_commit_due() {
+        const std::lock_guard<std::mutex> lock(m_mtxJournal);
+        return m_ulUncommitted > 0 && (m_ulUncommitted >= m_ulGroupCommit || tool::now() - m_ulFirstUncommitted >= m_ulCommitInterval);
+    }
+
+    void journal::set_commit_interval(uint64_t intervalMs) {
+        const std::lock_guard<std::mutex> lock(m_mtxJournal);
+        m_ulCommitInterval = intervalMs;
+    }
+
+    std::vector<journal::message_ptr> journal::replay() {
+        struct pending {
+            record_header header;
+            std::vector<uint8_t> payload;
+            bool alive;
+        };
+
+        const std::lock_guard<std::mutex> lock(m_mtxJournal);
+        std::vector<pending> posts;
+        std::unordered_map<uint64_t, size_t> index; // Satznummer -> Postsatz
+
+        for (uint64_t sequence : listSegments()) {
+            bool open = false;
+            for (auto& seg : m_vecSegments) open |= (seg.sequence == sequence);
+            if (open) continue;
+
+            std::ifstream file(segmentPath(sequence), std::ios::binary);
+            std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            m_vecReplayed.push_back(sequence);
+
+            segment_header seghead;
+            if (data.size() < JOURNAL_HEADER) continue;
+            std::memcpy(&seghead, data.data(), sizeof(seghead));
+            if (seghead.magic != JOURNAL_MAGIC || seghead.version != JOURNAL_VERSION) continue;
+
+            size_t offset = JOURNAL_HEADER;
+            while (offset + sizeof(record_header) <= data.size()) {
+                record_header header;
+                std::memcpy(&header, data.data() + offset, sizeof(header));
+                if (header.kind != RECORD_POST && header.kind != RECORD_TOMBSTONE) break;
+                if (offset + record_length(header.size) > data.size()) break;
+
+                const uint8_t* payload = data.data() + offset + sizeof(header);
+                if (checksum(header, payload) != header.checksum) break; // Abgerissener Schreibvorgang
+
+                if (header.kind == RECORD_POST) {
+                    index[header.record] = posts.size();
+                    posts.push_back(pending{ header, std::vector<uint8_t>(payload, payload + header.size), true });
+                }
+                else {
+                    auto entry = index.find(header.record);
+                    if (entry != index.end()) {
+                        posts[entry->second].alive = false;
+                        index.erase(entry);
+                    }
+                }
+                offset += record_length(header.size);
+            }
+        }
+
+        std::vector<message_ptr> result;
+        uint64_t wall = wall_now();
+        uint64_t now = tool::now();
+        for (auto& post : posts) {
+            if (!post.alive) continue;
+
+            auto factory = m_mapFactories.find(post.header.typetag);
+            if (factory == m_mapFactories.end()) continue;
+
+            message_ptr msg = factory->second(post.payload.data(), post.payload.size());
+            if (!msg) continue;
+
+            uint64_t age = (wall > post.header.timestamp) ? wall - post.header.timestamp : 0;
+            msg->set_priority(post.header.priority);
+            msg->set_alivems(post.header.alivems);
+            msg->set_typetag(post.header.typetag);
+            msg->set_timestamp((now > age) ? now - age : 0);
+            result.push_back(msg);
+        }
+        return result;
+    }
+
+    void journal::drop_replayed() {
+        const std::lock_guard<std::mutex> lock(m_mtxJournal);
+        for (uint64_t sequence : m_vecReplayed)
+            std::remove(segmentPath(sequence).c_str());
+        m_vecReplayed.clear();
+    }
+
+    bool journal::appendRecord(uint8_t kind, const message& msg, const uint8_t* payload, uint32_t size) {
+        size_t length = record_length(size);
+        if (JOURNAL_HEADER + length > m_ulSegmentSize) return false;
+
+        if (m_vecSegments.empty() || m_ulWriteOffset + length > m_ulSegmentSize) {
+            flush();
+            if (!openSegment()) return false;
+        }
+
+        record_header header = {};
+        header.size = size;
+        header.kind = kind;
+        header.priority = msg.get_priority();
+        header.id = msg.get_id().full;
+        header.record = m_ulNextRecord++;
+        header.timestamp = wall_now() - (tool::now() - msg.get_timestamp());
+        header.alivems = msg.get_alivems();
+        header.typetag = msg.get_typetag();
+        header.checksum = checksum(header, payload);
+
+        uint8_t* dest = m_vecSegments.back().data + m_ulWriteOffset;
+        std::memcpy(dest, &header, sizeof(header));
+        if (size > 0) std::memcpy(dest + sizeof(header), payload, size);
+        m_ulWriteOffset += length;
+
+        if (m_ulUncommitted++ == 0) m_ulFirstUncommitted = tool::now();
+        return true;
+    }
+
+    void journal::flush() {
+        if (m_vecSegments.empty() || m_ulFlushOffset == m_ulWriteOffset) return;
+
+        segment& current = m_vecSegments.back();
+        sync_range(current.data, current.file, m_ulFlushOffset, m_ulWriteOffset);
+        m_ulFlushOffset = m_ulWriteOffset;
+        m_ulUncommitted = 0;
+    }
+
+    void journal::trimSegments() {
+        // Nur von vorne kürzen: jüngere Segmente können Grabsteine für ältere enthalten
+        if (m_bCommitting) return;
+        while (m_vecSegments.size() > 1 && m_vecSegments.front().live == 0) {
+            closeSegment(m_vecSegments.front(), true);
+            m_vecSegments.erase(m_vecSegments.begin());
+        }
+    }
+
+    bool journal::openSegment() {
+        segment seg = {};
+        seg.sequence = m_ulNextSequence;
+        seg.path = segmentPath(seg.sequence);
+
+#ifdef _WIN32
+        HANDLE file = CreateFileA(seg.path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file == INVALID_HANDLE_VALUE) return false;
+
+        ULARGE_INTEGER size;
+        size.QuadPart = m_ulSegmentSize;
+        HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READWRITE, size.HighPart, size.LowPart, NULL);
+        void* data = (mapping != NULL) ? MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, m_ulSegmentSize) : NULL;
+        if (data == NULL) {
+            if (mapping != NULL) CloseHandle(mapping);
+            CloseHandle(file);
+            return false;
+        }
+        seg.file = reinterpret_cast<intptr_t>(file);
+        seg.mapping = mapping;
+#else
+        int file = ::open(seg.path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (file < 0) return false;
+
+        void* data = MAP_FAILED;
+        if (ftruncate(file, static_cast<off_t>(m_ulSegmentSize)) == 0)
+            data = mmap(NULL, m_ulSegmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+        if (data == MAP_FAILED) {
+            ::close(file);
+            std::remove(seg.path.c_str());
+            return false;
+        }
+        seg.file = file;
+        seg.mapping = nullptr;
+#endif
+        seg.data = static_cast<uint8_t*>(data);
+
+        segment_header header = {};
+        header.magic = JOURNAL_MAGIC;
+        header.version = JOURNAL_VERSION;
+        header.sequence = seg.sequence;
+        std::memcpy(seg.data, &header, sizeof(header));
+
+        m_vecSegments.push_back(seg);
+        m_ulNextSequence++;
+        m_ulNextRecord = seg.sequence << 32;
+        m_ulWriteOffset = JOURNAL_HEADER;
+        m_ulFlushOffset = 0;
+        return true;
+    }
+
+    void journal::closeSegment(segment& seg, bool remove) {
+#ifdef _WIN32
+        UnmapViewOfFile(seg.data);
+        CloseHandle(reinterpret_cast<HANDLE>(seg.mapping));
+        CloseHandle(reinterpret_cast<HANDLE>(seg.file));
+#else
+        munmap(seg.data, m_ulSegmentSize);
+        ::close(static_cast<int>(seg.file));
+#endif
+        if (remove)
+            std::remove(seg.path.c_str());
+    }
+
+    std::string journal::segmentPath(uint64_t sequence) const {
+        char name[32];
+        std::snprintf(name, sizeof(name), "ses_%016llx.wal", static_cast<unsigned long long>(sequence));
+        return m_strDirectory + "/" + name;
+    }
+
+    std::vector<uint64_t> journal::listSegments() const {
+        std::vector<uint64_t> result;
+        unsigned long long sequence = 0;
+#ifdef _WIN32
+        WIN32_FIND_DATAA entry;
+        HANDLE find = FindFirstFileA((m_strDirectory + "\\ses_*.wal").c_str(), &entry);
+        if (find != INVALID_HANDLE_VALUE) {
+            do {
+                if (std::sscanf(entry.cFileName, "ses_%16llx.wal", &sequence) == 1)
+                    result.push_back(sequence);
+            } while (FindNextFileA(find, &entry));
+            FindClose(find);
+        }
+#else
+        DIR* dir = opendir(m_strDirectory.c_str());
+        if (dir != nullptr) {
+            while (dirent* entry = readdir(dir)) {
+                if (std::strncmp(entry->d_name, "ses_", 4) == 0 && std::sscanf(entry->d_name, "ses_%16llx.wal", &sequence) == 1)
+                    result.push_back(sequence);
+            }
+            closedir(dir);
+        }
+#endif
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+}
@@ -0,0 +1,89 @@
+// SPDX-License-Identifier: EUPL-1.2
+
+#include "notifier.h"
+#include <cstdint>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <sys/eventfd.h>
+#endif
+
+namespace ses {
+
+#ifdef _WIN32
+    notifier::notifier() : m_handle(CreateEventA(NULL, TRUE, FALSE, NULL)) { }
+
+    notifier::~notifier() {
+        if (m_handle != NULL) CloseHandle(m_handle);
+    }
+
+    bool notifier::is_valid() const { return m_handle != NULL; }
+
+    void notifier::signal() { SetEvent(m_handle); }
+
+    void notifier::reset() { ResetEvent(m_handle); }
+#elif defined(__linux__)
+    notifier::notifier() : m_handle(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) { }
+
+    notifier::~notifier() {
+        if (m_handle >= 0) close(m_handle);
+    }
+
+    bool notifier::is_valid() const { return m_handle >= 0; }
+
+    void notifier::signal() {
+        uint64_t value = 1;
+        ssize_t written;
+        do {
+            written = write(m_handle, &value, sizeof(value));
+        } while (written < 0 && errno == EINTR);
+    }
+
+    void notifier::reset() {
+        // Ein Lesen setzt den Zähler des eventfd auf 0, EAGAIN heißt bereits zurückgesetzt
+        uint64_t value;
+        ssize_t bytes;
+        do {
+            bytes = read(m_handle, &value, sizeof(value));
+        } while (bytes < 0 && errno == EINTR);
+    }
+#else
+    notifier::notifier() : m_handle(-1), m_iWrite(-1) {
+        int fds[2];
+        if (pipe(fds) != 0) return;
+        for (int fd : fds) {
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+            fcntl(fd, F_SETFD, FD_CLOEXEC);
+        }
+        m_handle = fds[0];
+        m_iWrite = fds[1];
+    }
+
+    notifier::~notifier() {
+        if (m_handle >= 0) close(m_handle);
+        if (m_iWrite >= 0) close(m_iWrite);
+    }
+
+    bool notifier::is_valid() const { return m_handle >= 0; }
+
+    void notifier::signal() {
+        char value = 1;
+        ssize_t written;
+        do {
+            written = write(m_iWrite, &value, 1);
+        } while (written < 0 && errno == EINTR);
+    }
+
+    void notifier::reset() {
+        char buffer[64];
+        while (read(m_handle, buffer, sizeof(buffer)) > 0) { }
+    }
+#endif
+}
@@ -0,0 +1,136 @@
+// SPDX-License-Identifier: EUPL-1.2
+
+#include "numa_topology.h"
+#include <algorithm>
+#include <thread>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fstream>
+#include <sstream>
+#include <string>
+#endif
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace ses {
+
+    static unsigned cpu_count() {
+        unsigned count = std::thread::hardware_concurrency();
+        return (count == 0) ? 1 : count;
+    }
+
+#ifndef _WIN32
+    // Liest eine Prozessorliste im Format "0-3,8-11"
+    static std::vector<unsigned> parse_cpulist(const std::string& text) {
+        std::vector<unsigned> cpus;
+        std::stringstream stream(text);
+        std::string range;
+        while (std::getline(stream, range, ',')) {
+            if (range.empty() || range[0] == '\n') continue;
+            size_t dash = range.find('-');
+            unsigned first = static_cast<unsigned>(std::stoul(range.substr(0, dash)));
+            unsigned last = (dash == std::string::npos) ? first : static_cast<unsigned>(std::stoul(range.substr(dash + 1)));
+            for (unsigned cpu = first; cpu <= last; cpu++) cpus.push_back(cpu);
+        }
+        return cpus;
+    }
+#endif
+
+    numa_topology numa_topology::detect() {
+        numa_topology topology;
+#ifdef _WIN32
+        ULONG highest = 0;
+        if (GetNumaHighestNodeNumber(&highest)) {
+            for (USHORT node = 0; node <= highest; node++) {
+                GROUP_AFFINITY affinity;
+                if (!GetNumaNodeProcessorMaskEx(node, &affinity) || affinity.Mask == 0) continue;
+                std::vector<unsigned> cpus;
+                for (unsigned bit = 0; bit < sizeof(KAFFINITY) * 8; bit++) {
+                    if (affinity.Mask & (KAFFINITY(1) << bit))
+                        cpus.push_back(affinity.Group * 64 + bit);
+                }
+                topology.m_vecCpus.push_back(cpus);
+            }
+        }
+#else
+        for (int node = 0; ; node++) {
+            std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+            if (!file) break;
+            std::string text;
+            std::getline(file, text);
+            std::vector<unsigned> cpus = parse_cpulist(text);
+            if (!cpus.empty()) topology.m_vecCpus.push_back(cpus);
+        }
+#endif
+        if (topology.m_vecCpus.empty()) {
+            std::vector<unsigned> cpus(cpu_count());
+            for (unsigned cpu = 0; cpu < cpus.size(); cpu++) cpus[cpu] = cpu;
+            topology.m_vecCpus.push_back(cpus);
+        }
+        return topology;
+    }
+
+    numa_topology numa_topology::simulated(size_t nodes) {
+        numa_topology topology;
+        topology.m_bSimulated = true;
+        nodes = std::max<size_t>(nodes, 1);
+
+        unsigned count = cpu_count();
+        topology.m_vecCpus.resize(nodes);
+        for (size_t node = 0; node < nodes; node++) {
+            // Zusammenhängende Blöcke; gibt es weniger Prozessoren als Knoten, teilen sich Knoten einen Prozessor
+            unsigned first = static_cast<unsigned>(node * count / nodes);
+            unsigned last = static_cast<unsigned>((node + 1) * count / nodes);
+            if (last == first) last = first + 1;
+            for (unsigned cpu = first; cpu < last; cpu++)
+                topology.m_vecCpus[node].push_back(cpu % count);
+        }
+        return topology;
+    }
+
+    size_t numa_topology::node_of_cpu(unsigned cpu) const {
+        for (size_t node = 0; node < m_vecCpus.size(); node++) {
+            if (std::find(m_vecCpus[node].begin(), m_vecCpus[node].end(), cpu) != m_vecCpus[node].end())
+                return node;
+        }
+        return 0;
+    }
+
+    size_t numa_topology::current_node() const {
+#ifdef _WIN32
+        PROCESSOR_NUMBER number;
+        GetCurrentProcessorNumberEx(&number);
+        return node_of_cpu(number.Group * 64 + number.Number);
+#elif defined(__linux__)
+        int cpu = sched_getcpu();
+        return (cpu < 0) ? 0 : node_of_cpu(static_cast<unsigned>(cpu));
+#else
+        return 0;
+#endif
+    }
+
+    bool numa_topology::pin_thread(size_t node) const {
+        if (node >= m_vecCpus.size()) return false;
+        const std::vector<unsigned>& cpus = m_vecCpus[node];
+#ifdef _WIN32
+        GROUP_AFFINITY affinity = {};
+        affinity.Group = static_cast<WORD>(cpus.front() / 64);
+        for (unsigned cpu : cpus) {
+            if (cpu / 64 == affinity.Group) affinity.Mask |= KAFFINITY(1) << (cpu % 64);
+        }
+        return SetThreadGroupAffinity(GetCurrentThread(), &affinity, NULL) != 0;
+#elif defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (unsigned cpu : cpus) CPU_SET(cpu, &set);
+        return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+        return false;
+#endif
+    }
+}
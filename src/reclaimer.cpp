@@ -0,0 +1,76 @@
+// SPDX-License-Identifier: EUPL-1.2
+
+#include "reclaimer.h"
+
+namespace ses {
+
+    reclaimer::reclaimer(size_t maxGarbage, bool background)
+        : m_ulMaxGarbage((maxGarbage == 0) ? 1 : maxGarbage), m_bStop(false)
+    {
+        if (background)
+            m_thread = std::thread(&reclaimer::run, this);
+    }
+
+    reclaimer::~reclaimer() {
+        {
+            const std::lock_guard<std::mutex> lock(m_mtxGarbage);
+            m_bStop = true;
+        }
+        m_cvGarbage.notify_one();
+        if (m_thread.joinable())
+            m_thread.join();
+        reclaim();
+    }
+
+    void reclaimer::retire(std::vector<message_ptr>& batch) {
+        if (batch.empty()) return;
+
+        std::vector<message_ptr> overflow;
+        {
+            const std::lock_guard<std::mutex> lock(m_mtxGarbage);
+            if (m_vecGarbage.empty()) {
+                m_vecGarbage.swap(batch);
+            }
+            else {
+                m_vecGarbage.reserve(m_vecGarbage.size() + batch.size());
+                for (auto& msg : batch) m_vecGarbage.push_back(std::move(msg));
+            }
+            // Obergrenze überschritten: der Aufrufer gibt den Rückstand selbst frei
+            if (m_vecGarbage.size() > m_ulMaxGarbage)
+                overflow.swap(m_vecGarbage);
+        }
+        batch.clear();
+
+        if (overflow.empty())
+            m_cvGarbage.notify_one();
+        // overflow wird beim Verlassen außerhalb der Sperre zerstört
+    }
+
+    size_t reclaimer::reclaim() {
+        std::vector<message_ptr> garbage;
+        {
+            const std::lock_guard<std::mutex> lock(m_mtxGarbage);
+            garbage.swap(m_vecGarbage);
+        }
+        return garbage.size();
+    }
+
+    size_t reclaimer::get_outstanding() const {
+        const std::lock_guard<std::mutex> lock(m_mtxGarbage);
+        return m_vecGarbage.size();
+    }
+
+    void reclaimer::run() {
+        std::unique_lock<std::mutex> lock(m_mtxGarbage);
+        while (true) {
+            m_cvGarbage.wait(lock, [this] { return m_bStop || !m_vecGarbage.empty(); });
+            if (m_bStop) return;
+
+            std::vector<message_ptr> garbage;
+            garbage.swap(m_vecGarbage);
+            lock.unlock();
+            garbage.clear(); // Destruktoren laufen hier ohne jede Sperre
+            lock.lock();
+        }
+    }
+}
@@ -0,0 +1,98 @@
+// SPDX-License-Identifier: EUPL-1.2
+
+#include "recorder.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace ses {
+
+    static const char RECORD_MAGIC[4] = { 'S', 'E', 'S', 'R' };
+    static const uint32_t RECORD_VERSION = 1;
+    static const size_t RECORD_FLUSH = 4096; // Sätze, nach denen der Puffer in die Datei geschrieben wird
+
+    recorder::recorder() : m_ulStart(0), m_ulRecords(0) { }
+
+    recorder::~recorder() {
+        close();
+    }
+
+    uint64_t recorder::clock_ns() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    bool recorder::open(const std::string& path) {
+        const std::lock_guard<std::mutex> lock(m_mtxFile);
+        if (m_file.is_open()) {
+            flush();
+            m_file.close();
+        }
+        m_file.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!m_file) return false;
+
+        m_file.write(RECORD_MAGIC, sizeof(RECORD_MAGIC));
+        m_file.write(reinterpret_cast<const char*>(&RECORD_VERSION), sizeof(RECORD_VERSION));
+        m_vecBuffer.reserve(RECORD_FLUSH);
+        m_ulStart = clock_ns();
+        m_ulRecords = 0;
+        return static_cast<bool>(m_file);
+    }
+
+    void recorder::close() {
+        const std::lock_guard<std::mutex> lock(m_mtxFile);
+        if (!m_file.is_open()) return;
+        flush();
+        m_file.close();
+    }
+
+    bool recorder::is_open() const {
+        const std::lock_guard<std::mutex> lock(m_mtxFile);
+        return m_file.is_open();
+    }
+
+    size_t recorder::get_records() const {
+        const std::lock_guard<std::mutex> lock(m_mtxFile);
+        return m_ulRecords;
+    }
+
+    void recorder::recordPost(const message& msg) {
+        recorded_event record;
+        std::memset(&record, 0, sizeof(record));
+        record.id = msg.get_id().full;
+        record.typetag = msg.get_typetag();
+        record.value = msg.get_alivems();
+        record.kind = record_kind::post;
+        record.priority = msg.get_priority();
+        append(record);
+    }
+
+    void recorder::recordOutcome(const message& msg, bool success, uint64_t costNs) {
+        recorded_event record;
+        std::memset(&record, 0, sizeof(record));
+        record.id = msg.get_id().full;
+        record.typetag = msg.get_typetag();
+        record.value = static_cast<uint32_t>(std::min<uint64_t>(costNs, UINT32_MAX));
+        record.kind = success ? record_kind::success : record_kind::discard;
+        record.priority = msg.get_priority();
+        append(record);
+    }
+
+    void recorder::append(const recorded_event& record) {
+        const std::lock_guard<std::mutex> lock(m_mtxFile);
+        if (!m_file.is_open()) return;
+
+        m_vecBuffer.push_back(record);
+        m_vecBuffer.back().time = (clock_ns() - m_ulStart) / 1000;
+        m_ulRecords++;
+        if (m_vecBuffer.size() >= RECORD_FLUSH)
+            flush();
+    }
+
+    void recorder::flush() {
+        if (m_vecBuffer.empty()) return;
+        m_file.write(reinterpret_cast<const char*>(m_vecBuffer.data()), m_vecBuffer.size() * sizeof(recorded_event));
+        m_file.flush();
+        m_vecBuffer.clear();
+    }
+}
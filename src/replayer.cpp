@@ -0,0 +1,165 @@
+// SPDX-License-Identifier: EUPL-1.2
+
+#include "replayer.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <unordered_map>
+
+namespace ses {
+
+    enum class replay_state : uint8_t {
+        waiting = 0,
+        processed,
+        discarded,
+        expired,
+        rejected
+    };
+
+    // Synthetische Nachricht, die die aufgezeichneten Handler-Ergebnisse und -Dauern nachbildet
+    class replay_message : public message {
+    public:
+        replay_message(const std::vector<std::pair<bool, uint32_t>>* pOutcomes, uint8_t prio, uint32_t alivems, uint32_t typetag)
+            : message(prio, alivems), m_pOutcomes(pOutcomes), m_ulNext(0), m_ulPosted(0), m_ulDone(0), m_eState(replay_state::waiting)
+        {
+            set_typetag(typetag);
+        }
+
+        void onMessagePost(void* /*sender*/, bool bWasAdd) override {
+            if (!bWasAdd) finish(replay_state::rejected);
+        }
+        bool onMessageProcess(void* /*sender*/) override {
+            bool success = true;
+            uint64_t cost = 0;
+            if (m_ulNext < m_pOutcomes->size()) {
+                success = (*m_pOutcomes)[m_ulNext].first;
+                cost = (*m_pOutcomes)[m_ulNext].second;
+                m_ulNext++;
+            }
+            else if (!m_pOutcomes->empty()) {
+                // Mehr Versuche als aufgezeichnet: mit der letzten Dauer erfolgreich abschließen
+                cost = m_pOutcomes->back().second;
+            }
+            uint64_t until = recorder::clock_ns() + cost;
+            while (recorder::clock_ns() < until) { }
+
+            if (success) finish(replay_state::processed);
+            return success;
+        }
+        void onMessageDiscard(void* /*sender*/, uint64_t /*time*/) override { finish(replay_state::discarded); }
+        void onMessageExpired(void* /*sender*/, uint64_t /*time*/) override { finish(replay_state::expired); }
+
+        void set_posted(uint64_t ns) { m_ulPosted = ns; }
+        uint64_t get_posted() const { return m_ulPosted; }
+        uint64_t get_done() const { return m_ulDone; }
+        replay_state get_state() const { return m_eState; }
+    private:
+        void finish(replay_state state) {
+            if (m_eState != replay_state::waiting) return;
+            m_eState = state;
+            m_ulDone = recorder::clock_ns();
+        }
+    private:
+        const std::vector<std::pair<bool, uint32_t>>* m_pOutcomes;
+        size_t m_ulNext;
+        uint64_t m_ulPosted;
+        uint64_t m_ulDone;
+        replay_state m_eState;
+    };
+
+    bool replayer::load(const std::string& path) {
+        std::ifstream file(path, std::ios::in | std::ios::binary);
+        if (!file) return false;
+
+        char magic[4];
+        uint32_t version = 0;
+        file.read(magic, sizeof(magic));
+        file.read(reinterpret_cast<char*>(&version), sizeof(version));
+        if (!file || std::memcmp(magic, "SESR", 4) != 0 || version != 1) return false;
+
+        m_vecItems.clear();
+        std::unordered_map<uint64_t, size_t> mapIndex;
+        recorded_event record;
+        while (file.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+            if (record.kind == record_kind::post) {
+                replay_item item = { record.time, record.typetag, record.value, record.priority, {} };
+                // Erneut gepostete Nachrichten (etwa nach restoreMessages) zählen als neue Nachricht
+                mapIndex[record.id] = m_vecItems.size();
+                m_vecItems.push_back(std::move(item));
+            }
+            else {
+                auto entry = mapIndex.find(record.id);
+                if (entry == mapIndex.end()) continue;
+                m_vecItems[entry->second].outcomes.emplace_back(record.kind == record_kind::success, record.value);
+            }
+        }
+        return true;
+    }
+
+    replay_stats replayer::run(eventmanager& manager, double speed) const {
+        std::vector<std::shared_ptr<replay_message>> msgs;
+        msgs.reserve(m_vecItems.size());
+        for (const replay_item& item : m_vecItems)
+            msgs.push_back(std::make_shared<replay_message>(&item.outcomes, item.priority, item.alivems, item.typetag));
+
+        std::atomic<bool> posted(false);
+        std::thread producer([&] {
+            uint64_t base = recorder::clock_ns();
+            for (size_t i = 0; i < msgs.size(); i++) {
+                if (speed > 0) {
+                    uint64_t due = base + static_cast<uint64_t>(m_vecItems[i].time * 1000.0 / speed);
+                    uint64_t now = recorder::clock_ns();
+                    if (due > now) std::this_thread::sleep_for(std::chrono::nanoseconds(due - now));
+                }
+                msgs[i]->set_timestamp(tool::now());
+                msgs[i]->set_posted(recorder::clock_ns());
+                manager.postMessage(msgs[i], TIMEDLOCK_INFINITY_WAIT);
+            }
+            posted = true;
+        });
+
+        while (!posted.load() || manager.get_messages() > 0) {
+            if (manager.get_messages() == 0) {
+                std::this_thread::yield();
+                continue;
+            }
+            manager.beginMessages();
+            manager.processMessages(0, 255);
+            manager.endProcessMessages();
+        }
+        producer.join();
+
+        replay_stats stats;
+        std::memset(&stats, 0, sizeof(stats));
+        std::vector<uint64_t> latencies;
+        latencies.reserve(msgs.size());
+        uint64_t first = UINT64_MAX, last = 0;
+        for (auto& msg : msgs) {
+            stats.posted++;
+            first = std::min(first, msg->get_posted());
+            switch (msg->get_state()) {
+            case replay_state::rejected: stats.rejected++; continue;
+            case replay_state::processed: stats.processed++; break;
+            case replay_state::discarded: stats.discarded++; break;
+            case replay_state::expired: stats.expired++; break;
+            default: continue;
+            }
+            last = std::max(last, msg->get_done());
+            latencies.push_back((msg->get_done() - msg->get_posted()) / 1000);
+        }
+        if (latencies.empty()) return stats;
+
+        std::sort(latencies.begin(), latencies.end());
+        uint64_t sum = 0;
+        for (uint64_t latency : latencies) sum += latency;
+        stats.seconds = (last - first) / 1e9;
+        stats.throughput = (stats.seconds > 0) ? latencies.size() / stats.seconds : 0;
+        stats.latency_avg_us = static_cast<double>(sum) / latencies.size();
+        stats.latency_p50_us = latencies[latencies.size() / 2];
+        stats.latency_p99_us = latencies[std::min(latencies.size() - 1, latencies.size() * 99 / 100)];
+        stats.latency_max_us = latencies.back();
+        return stats;
+    }
+}
@@ -0,0 +1,87 @@
+// SPDX-License-Identifier: EUPL-1.2
+
+#include "sharded_eventmanager.h"
+#include <thread>
+
+namespace ses {
+    // Mit pin_worker gesetzter Knoten des Threads, -1 = über den laufenden Prozessor bestimmen
+    static thread_local int t_iWorkerNode = -1;
+
+    sharded_eventmanager::sharded_eventmanager(const numa_topology& topology, uint64_t timedWaitMax, uint8_t tolerance)
+        : m_topology(topology), m_vecShards(topology.get_nodes()), m_ucTolerance(tolerance), m_ulSteals(0)
+    {
+        // Jeder Shard wird auf seinem Knoten angelegt, damit sein Speicher dort liegt (first touch)
+        std::vector<std::thread> threads;
+        for (size_t node = 0; node < m_vecShards.size(); node++) {
+            threads.emplace_back([this, node, timedWaitMax] {
+                m_topology.pin_thread(node);
+                m_vecShards[node].reset(new eventmanager(timedWaitMax));
+            });
+        }
+        for (auto& thread : threads) thread.join();
+    }
+
+    bool sharded_eventmanager::pin_worker(size_t node) {
+        if (node >= m_vecShards.size()) return false;
+        t_iWorkerNode = static_cast<int>(node);
+        return m_topology.pin_thread(node);
+    }
+
+    size_t sharded_eventmanager::local_node() const {
+        if (t_iWorkerNode >= 0 && static_cast<size_t>(t_iWorkerNode) < m_vecShards.size())
+            return static_cast<size_t>(t_iWorkerNode);
+        return m_topology.current_node() % m_vecShards.size();
+    }
+
+    post_result sharded_eventmanager::postMessage(message_ptr msg, uint64_t maxWaitTime) {
+        return m_vecShards[local_node()]->postMessage(msg, maxWaitTime);
+    }
+
+    post_result sharded_eventmanager::postMessage(size_t node, message_ptr msg, uint64_t maxWaitTime) {
+        return m_vecShards[node % m_vecShards.size()]->postMessage(msg, maxWaitTime);
+    }
+
+    void sharded_eventmanager::clearMessages() {
+        for (auto& shard : m_vecShards) shard->clearMessages();
+    }
+
+    size_t sharded_eventmanager::get_messages() const {
+        size_t count = 0;
+        for (auto& shard : m_vecShards) count += shard->get_messages();
+        return count;
+    }
+
+    int sharded_eventmanager::processMessages(int from, int to) {
+        const size_t count = m_vecShards.size();
+        const size_t local = local_node();
+        const int localTop = m_vecShards[local]->get_top_priority(from, to);
+
+        // Wichtigste Nachricht der fremden Shards, nähere Knoten zuerst
+        size_t best = local;
+        int bestTop = -1;
+        for (size_t step = 1; step < count; step++) {
+            size_t node = (local + step) % count;
+            int top = m_vecShards[node]->get_top_priority(from, to);
+            if (top >= 0 && (bestTop < 0 || top < bestTop)) {
+                best = node;
+                bestTop = top;
+            }
+        }
+
+        size_t target;
+        if (localTop >= 0 && (bestTop < 0 || localTop <= bestTop + m_ucTolerance))
+            target = local;
+        else if (bestTop >= 0) {
+            target = best;
+            m_ulSteals++;
+        }
+        else
+            return -1;
+
+        eventmanager& shard = *m_vecShards[target];
+        shard.beginMessages();
+        shard.processMessages(from, to);
+        shard.endProcessMessages();
+        return static_cast<int>(target);
+    }
+}
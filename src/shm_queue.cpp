@@ -0,0 +1,384 @@
+// SPDX-License-Identifier: EUPL-1.2
+
+#include "shm_queue.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ses {
+    static_assert(ATOMIC_INT_LOCK_FREE == 2, "shm_queue benötigt sperrfreie 32-Bit-Atomics");
+
+    static const uint32_t SHM_MAGIC = 0x51534553; // "SESQ"
+    static const uint32_t SHM_NIL = 0xFFFFFFFFu;
+    static const uint8_t  SHM_MAXDISCARDS = 5;
+    static const uint64_t SHM_ATTACH_TIMEOUT = 1000; // Millisekunden bis zur fertigen Initialisierung durch den Erzeuger
+
+    enum shm_state : uint8_t { slot_free = 0, slot_reserved, slot_queued, slot_busy };
+
+    struct shm_queue_header {
+        std::atomic<uint32_t> magic;
+        uint32_t slotSize;
+        uint32_t capacity;
+        std::atomic<uint32_t> lock;   // PID des Halters, 0 = frei
+        uint32_t freeHead;
+        uint32_t count;
+        uint32_t heads[256];
+        uint32_t tails[256];
+    };
+
+    struct shm_queue_slot {
+        uint32_t next;
+        uint32_t size;
+        uint32_t typetag;
+        uint32_t owner;      // PID des reservierenden bzw. verarbeitenden Prozesses
+        uint64_t timestamp;
+        uint32_t alivems;
+        uint8_t  priority;
+        uint8_t  state;
+        uint8_t  discards;
+        uint8_t  reserved;
+        // Nutzdaten folgen
+    };
+
+    static size_t header_size() {
+        return (sizeof(shm_queue_header) + 63) & ~size_t(63);
+    }
+
+    static size_t slot_stride(size_t slotSize) {
+        return (sizeof(shm_queue_slot) + slotSize + 63) & ~size_t(63);
+    }
+
+    static uint32_t current_pid() {
+#ifdef _WIN32
+        return static_cast<uint32_t>(GetCurrentProcessId());
+#else
+        return static_cast<uint32_t>(getpid());
+#endif
+    }
+
+    static bool process_alive(uint32_t pid) {
+#ifdef _WIN32
+        HANDLE process = OpenProcess(SYNCHRONIZE, FALSE, pid);
+        if (process == NULL) return false;
+        bool alive = WaitForSingleObject(process, 0) == WAIT_TIMEOUT;
+        CloseHandle(process);
+        return alive;
+#else
+        return kill(static_cast<pid_t>(pid), 0) == 0 || errno != ESRCH;
+#endif
+    }
+
+    shm_queue::shm_queue(const std::string& name, size_t slotSize, size_t capacity, bool create)
+        : m_strName(name), m_pBase(nullptr), m_ulMapSize(header_size() + slot_stride(slotSize) * capacity), m_pMapping(nullptr), m_uiPid(current_pid())
+    {
+        if (capacity == 0 || capacity >= SHM_NIL) return;
+
+        // Genau ein Prozess legt den Bereich neu an und initialisiert ihn, alle anderen öffnen ihn nur
+        bool initialize = false;
+#ifdef _WIN32
+        ULARGE_INTEGER size;
+        size.QuadPart = m_ulMapSize;
+        HANDLE mapping = NULL;
+        if (create) {
+            mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, size.HighPart, size.LowPart, name.c_str());
+            initialize = (mapping != NULL && GetLastError() != ERROR_ALREADY_EXISTS);
+        }
+        else
+            mapping = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, name.c_str());
+        if (mapping == NULL) return;
+        // Ist ein bestehender Bereich kleiner als erwartet, schlägt die Abbildung fehl
+        void* data = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, m_ulMapSize);
+        if (data == NULL) {
+            CloseHandle(mapping);
+            return;
+        }
+        m_pMapping = mapping;
+#else
+        int file = -1;
+        if (create) {
+            file = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+            if (file >= 0) {
+                initialize = true;
+                if (ftruncate(file, static_cast<off_t>(m_ulMapSize)) != 0) {
+                    ::close(file);
+                    shm_unlink(name.c_str());
+                    return;
+                }
+            }
+            else if (errno != EEXIST)
+                return;
+        }
+        if (file < 0) {
+            file = shm_open(name.c_str(), O_RDWR, 0600);
+            if (file < 0) return;
+
+            // Ein bestehender Bereich wird nie vergrößert: warten, bis der Erzeuger die Größe gesetzt hat, dann prüfen
+            uint64_t start = tool::now();
+            struct stat info;
+            while (true) {
+                if (fstat(file, &info) != 0 || (info.st_size != 0 && static_cast<size_t>(info.st_size) != m_ulMapSize)
+                    || (info.st_size == 0 && tool::now() - start >= SHM_ATTACH_TIMEOUT)) {
+                    ::close(file);
+                    return;
+                }
+                if (info.st_size != 0) break;
+                std::this_thread::yield();
+            }
+        }
+        void* data = mmap(NULL, m_ulMapSize, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+        ::close(file);
+        if (data == MAP_FAILED) return;
+#endif
+        m_pBase = static_cast<uint8_t*>(data);
+        shm_queue_header* head = header();
+
+        if (initialize) {
+            head->slotSize = static_cast<uint32_t>(slotSize);
+            head->capacity = static_cast<uint32_t>(capacity);
+            head->lock.store(0);
+            head->count = 0;
+            for (int prio = 0; prio < 256; prio++)
+                head->heads[prio] = head->tails[prio] = SHM_NIL;
+            for (uint32_t index = 0; index < capacity; index++) {
+                shm_queue_slot* entry = slot(index);
+                entry->state = slot_free;
+                entry->next = (index + 1 < capacity) ? index + 1 : SHM_NIL;
+            }
+            head->freeHead = 0;
+            head->magic.store(SHM_MAGIC, std::memory_order_release);
+        }
+        else {
+            // Begrenzt warten, bis der erzeugende Prozess den Kopf initialisiert hat; ein abgebrochener Erzeuger hinterlässt keine Kennung
+            uint64_t start = tool::now();
+            while (head->magic.load(std::memory_order_acquire) != SHM_MAGIC) {
+                if (tool::now() - start >= SHM_ATTACH_TIMEOUT) {
+                    unmap();
+                    return;
+                }
+                std::this_thread::yield();
+            }
+            if (head->slotSize != slotSize || head->capacity != capacity)
+                unmap();
+        }
+    }
+
+    shm_queue::~shm_queue() {
+        unmap();
+    }
+
+    void shm_queue::unmap() {
+        if (m_pBase == nullptr) return;
+#ifdef _WIN32
+        UnmapViewOfFile(m_pBase);
+        CloseHandle(m_pMapping);
+#else
+        munmap(m_pBase, m_ulMapSize);
+#endif
+        m_pBase = nullptr;
+    }
+
+    void shm_queue::unlink(const std::string& name) {
+#ifndef _WIN32
+        shm_unlink(name.c_str());
+#endif
+    }
+
+    shm_queue_header* shm_queue::header() const {
+        return reinterpret_cast<shm_queue_header*>(m_pBase);
+    }
+
+    shm_queue_slot* shm_queue::slot(uint32_t index) const {
+        return reinterpret_cast<shm_queue_slot*>(m_pBase + header_size() + slot_stride(header()->slotSize) * index);
+    }
+
+    void shm_queue::lock() {
+        shm_queue_header* head = header();
+        uint32_t spins = 0;
+        while (true) {
+            uint32_t expected = 0;
+            if (head->lock.compare_exchange_weak(expected, m_uiPid, std::memory_order_acquire))
+                return;
+            // Sperre eines beendeten Prozesses übernehmen (robustes Sperren). Er kann mitten in einer Listenänderung beendet worden
+            // sein, die Listen werden daher aus den Zuständen der Slots neu aufgebaut.
+            if (expected != 0 && ++spins % 1024 == 0 && !process_alive(expected)) {
+                if (head->lock.compare_exchange_strong(expected, m_uiPid, std::memory_order_acquire)) {
+                    rebuild();
+                    return;
+                }
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    void shm_queue::unlock() {
+        header()->lock.store(0, std::memory_order_release);
+    }
+
+    void shm_queue::pushBack(uint32_t index) {
+        shm_queue_header* head = header();
+        shm_queue_slot* entry = slot(index);
+        entry->next = SHM_NIL;
+        entry->state = slot_queued;
+
+        uint32_t& tail = head->tails[entry->priority];
+        if (tail == SHM_NIL) head->heads[entry->priority] = index;
+        else slot(tail)->next = index;
+        tail = index;
+        head->count++;
+    }
+
+    void shm_queue::release(uint32_t index) {
+        shm_queue_header* head = header();
+        shm_queue_slot* entry = slot(index);
+        entry->state = slot_free;
+        entry->next = head->freeHead;
+        head->freeHead = index;
+    }
+
+    void shm_queue::rebuild() {
+        // Jede Listenänderung setzt den Zustand des Slots, der Zustand ist daher auch nach einem Abbruch maßgeblich
+        shm_queue_header* head = header();
+        std::vector<uint32_t> queued;
+        head->freeHead = SHM_NIL;
+        head->count = 0;
+        for (int prio = 0; prio < 256; prio++)
+            head->heads[prio] = head->tails[prio] = SHM_NIL;
+        for (uint32_t index = head->capacity; index-- > 0; ) {
+            shm_queue_slot* entry = slot(index);
+            if (entry->state == slot_free) release(index);
+            else if (entry->state == slot_queued) queued.push_back(index);
+        }
+        // Innerhalb einer Priorität in Sendereihenfolge wieder einreihen
+        std::stable_sort(queued.begin(), queued.end(), [this](uint32_t a, uint32_t b) { return slot(a)->timestamp < slot(b)->timestamp; });
+        for (uint32_t index : queued) pushBack(index);
+    }
+
+    void* shm_queue::reserveMessage(uint32_t& index) {
+        if (m_pBase == nullptr) return nullptr;
+        shm_queue_header* head = header();
+
+        lock();
+        index = head->freeHead;
+        if (index != SHM_NIL) {
+            shm_queue_slot* entry = slot(index);
+            head->freeHead = entry->next;
+            entry->state = slot_reserved;
+            entry->owner = m_uiPid;
+        }
+        unlock();
+        return (index != SHM_NIL) ? reinterpret_cast<uint8_t*>(slot(index)) + sizeof(shm_queue_slot) : nullptr;
+    }
+
+    bool shm_queue::commitMessage(uint32_t index, uint8_t prio, uint32_t typeTag, size_t size, uint32_t aliveMs) {
+        if (m_pBase == nullptr || index >= header()->capacity || size > header()->slotSize) return false;
+
+        lock();
+        // Nur eigene Reservierungen, ein fremder oder bereits eingereihter Slot würde die Listen zerstören
+        shm_queue_slot* entry = slot(index);
+        bool valid = entry->state == slot_reserved && entry->owner == m_uiPid;
+        if (valid) {
+            entry->size = static_cast<uint32_t>(size);
+            entry->typetag = typeTag;
+            entry->priority = prio;
+            entry->timestamp = tool::now();
+            entry->alivems = aliveMs;
+            entry->discards = 0;
+            pushBack(index);
+        }
+        unlock();
+        return valid;
+    }
+
+    bool shm_queue::postMessage(uint8_t prio, uint32_t typeTag, const void* data, size_t size, uint32_t aliveMs) {
+        if (m_pBase == nullptr || size > header()->slotSize) return false;
+
+        uint32_t index;
+        void* dest = reserveMessage(index);
+        if (dest == nullptr) return false;
+
+        std::memcpy(dest, data, size);
+        return commitMessage(index, prio, typeTag, size, aliveMs);
+    }
+
+    size_t shm_queue::processMessages(int from, int to, process_func func, size_t maxCount) {
+        if (m_pBase == nullptr) return 0;
+        shm_queue_header* head = header();
+        from = std::max(from, 0);
+        to = std::min(to, 255);
+
+        size_t processed = 0;
+        while (processed < maxCount) {
+            uint32_t index = SHM_NIL;
+
+            lock();
+            for (int prio = from; prio <= to && index == SHM_NIL; prio++) {
+                index = head->heads[prio];
+                if (index == SHM_NIL) continue;
+
+                shm_queue_slot* entry = slot(index);
+                head->heads[prio] = entry->next;
+                if (entry->next == SHM_NIL) head->tails[prio] = SHM_NIL;
+                entry->state = slot_busy;
+                entry->owner = m_uiPid;
+                head->count--;
+            }
+            unlock();
+            if (index == SHM_NIL) break;
+
+            shm_queue_slot* entry = slot(index);
+            uint64_t now = tool::now();
+            bool expired = entry->alivems > 0 && now > entry->timestamp + entry->alivems;
+            bool done = expired || func(entry->priority, entry->typetag, reinterpret_cast<uint8_t*>(entry) + sizeof(shm_queue_slot), entry->size);
+
+            lock();
+            if (done || ++entry->discards >= SHM_MAXDISCARDS) release(index);
+            else pushBack(index);
+            unlock();
+
+            if (!expired) processed++;
+        }
+        return processed;
+    }
+
+    size_t shm_queue::recoverMessages() {
+        if (m_pBase == nullptr) return 0;
+        shm_queue_header* head = header();
+
+        size_t recovered = 0;
+        lock();
+        for (uint32_t index = 0; index < head->capacity; index++) {
+            shm_queue_slot* entry = slot(index);
+            if (entry->state != slot_busy && entry->state != slot_reserved) continue;
+            if (entry->owner == m_uiPid || process_alive(entry->owner)) continue;
+
+            if (entry->state == slot_busy) {
+                pushBack(index);
+                recovered++;
+            }
+            else if (entry->state == slot_reserved) {
+                release(index);
+            }
+        }
+        unlock();
+        return recovered;
+    }
+
+    size_t shm_queue::get_messages() const {
+        if (m_pBase == nullptr) return 0;
+        return header()->count;
+    }
+}
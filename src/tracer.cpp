@@ -0,0 +1,142 @@
+// SPDX-License-Identifier: EUPL-1.2
+
+#include "tracer.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+
+namespace ses {
+
+    static thread_local void* t_pRing = nullptr;
+
+    static const char* event_name(trace_event event) {
+        switch (event) {
+        case trace_event::post: return "post";
+        case trace_event::deferred: return "deferred";
+        case trace_event::reject: return "reject";
+        case trace_event::evict: return "evict";
+        case trace_event::handler_begin: return "handler";
+        case trace_event::handler_end: return "handler";
+        case trace_event::discard: return "discard";
+        case trace_event::expire: return "expire";
+        default: return "remove";
+        }
+    }
+
+    tracer& tracer::instance() {
+        static tracer s_tracer;
+        return s_tracer;
+    }
+
+    tracer::tracer() : m_bEnabled(false), m_uiSampling(1), m_ulCapacity(65536) { }
+
+    void tracer::set_capacity(size_t records) {
+        size_t capacity = 1;
+        while (capacity < records) capacity <<= 1;
+        const std::lock_guard<std::mutex> lock(m_mtxRings);
+        m_ulCapacity = capacity;
+    }
+
+    tracer::ring* tracer::local_ring() {
+        if (t_pRing != nullptr) return static_cast<ring*>(t_pRing);
+
+        // Erster Eintrag des Threads: Ring anlegen und registrieren, danach ohne Sperre
+        std::shared_ptr<ring> created = std::make_shared<ring>();
+        const std::lock_guard<std::mutex> lock(m_mtxRings);
+        created->records.reset(new trace_record[m_ulCapacity]());
+        created->mask = m_ulCapacity - 1;
+        created->thread = static_cast<uint32_t>(m_vecRings.size());
+        created->head.store(0);
+        created->floor.store(0);
+        m_vecRings.push_back(created);
+        t_pRing = created.get();
+        return created.get();
+    }
+
+    void tracer::write(trace_event event, uint64_t id, uint8_t priority) {
+        ring* target = local_ring();
+        uint64_t pos = target->head.load(std::memory_order_relaxed);
+        trace_record& record = target->records[pos & target->mask];
+
+        // Sequenz-Sperre: 0 kennzeichnet einen Eintrag, der gerade geschrieben wird
+        record.sequence.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        record.time = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+        record.id = id;
+        record.thread = target->thread;
+        record.event = event;
+        record.priority = priority;
+        record.sequence.store(pos + 1, std::memory_order_release);
+        target->head.store(pos + 1, std::memory_order_release);
+    }
+
+    void tracer::clear() {
+        const std::lock_guard<std::mutex> lock(m_mtxRings);
+        // Nur die Untergrenze verschieben, der Schreibpfad bleibt ungestört
+        for (auto& entry : m_vecRings)
+            entry->floor.store(entry->head.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+    size_t tracer::dump_chrome(std::ostream& out) const {
+        struct copy {
+            uint64_t time;
+            uint64_t id;
+            uint32_t thread;
+            trace_event event;
+            uint8_t priority;
+        };
+        std::vector<copy> records;
+        {
+            const std::lock_guard<std::mutex> lock(m_mtxRings);
+            for (auto& entry : m_vecRings) {
+                uint64_t head = entry->head.load(std::memory_order_acquire);
+                uint64_t first = std::max(entry->floor.load(std::memory_order_acquire), (head > entry->mask) ? head - entry->mask - 1 : 0);
+                for (uint64_t pos = first; pos < head; pos++) {
+                    const trace_record& record = entry->records[pos & entry->mask];
+                    uint64_t before = record.sequence.load(std::memory_order_acquire);
+                    copy value = { record.time, record.id, record.thread, record.event, record.priority };
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    // Während des Lesens überschriebene Einträge auslassen
+                    if (before != pos + 1 || record.sequence.load(std::memory_order_relaxed) != before) continue;
+                    records.push_back(value);
+                }
+            }
+        }
+        std::stable_sort(records.begin(), records.end(), [](const copy& a, const copy& b) { return a.time < b.time; });
+
+        out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+        char buffer[256];
+        for (size_t i = 0; i < records.size(); i++) {
+            const copy& record = records[i];
+            const char* phase;
+            switch (record.event) {
+            case trace_event::post: phase = "b"; break;
+            case trace_event::evict:
+            case trace_event::remove: phase = "e"; break;
+            case trace_event::handler_begin: phase = "B"; break;
+            case trace_event::handler_end: phase = "E"; break;
+            default: phase = "i"; break;
+            }
+            // Asynchrone Abschnitte (b/e) tragen die Lebensdauer, Namen müssen für Anfang und Ende gleich sein
+            const char* name = (phase[0] == 'b' || phase[0] == 'e') ? "message" : event_name(record.event);
+            snprintf(buffer, sizeof(buffer),
+                "%s\n{\"name\":\"%s\",\"cat\":\"ses\",\"ph\":\"%s\",\"ts\":%.3f,\"pid\":1,\"tid\":%u,\"id\":\"0x%llx\",%s\"args\":{\"id\":\"0x%llx\",\"priority\":%u%s}}",
+                (i == 0) ? "" : ",", name, phase, record.time / 1000.0, record.thread,
+                static_cast<unsigned long long>(record.id), (phase[0] == 'i') ? "\"s\":\"t\"," : "",
+                static_cast<unsigned long long>(record.id), record.priority,
+                (record.event == trace_event::evict) ? ",\"evicted\":true" : "");
+            out << buffer;
+        }
+        out << "\n]}\n";
+        return records.size();
+    }
+
+    bool tracer::dump_chrome(const std::string& path) const {
+        std::ofstream file(path, std::ios::out | std::ios::trunc);
+        if (!file) return false;
+        dump_chrome(file);
+        return static_cast<bool>(file);
+    }
+}